@@ -0,0 +1,195 @@
+// 向量化回測引擎的效能測試：與逐筆記錄交易的直觀寫法比對結果，並量測單核與多執行緒的吞吐量
+// 用法：BacktestBenchmark [股票數=2000] [年數=10] [執行緒數=0]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include "Backtester.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "ParallelBatch.h"
+#include "SyntheticCandles.h"
+
+namespace
+{
+    struct Symbol
+    {
+        CandleColumns candles;
+        IndicatorColumns indicators;
+    };
+
+    // 幾何布朗運動產生的模擬 K 線，並以預設設定算出訊號欄位
+    std::vector<Symbol> generateSymbols(size_t symbols, size_t steps, const SignalConfig &config, int lookback)
+    {
+        SyntheticCandles generator(20240601);
+        IndicatorPipeline pipeline(config);
+        std::vector<Symbol> result(symbols);
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            CandleColumns &candles = result[s].candles;
+            candles.reserve(steps);
+            generator.reset(SyntheticCandles::startPrice(s));
+            for (size_t t = 0; t < steps; ++t)
+            {
+                SyntheticCandle c = generator.next();
+                candles.push_back(Candle(c.open, c.high, c.low, c.close, c.volume));
+            }
+            pipeline.run(candles, result[s].indicators, lookback);
+        }
+        return result;
+    }
+
+    // 直觀寫法：先建出部位、報酬、權益與交易清單，再各自統計
+    BacktestResult naiveBacktest(const Symbol &symbol, const BacktestConfig &config)
+    {
+        struct Trade
+        {
+            size_t entry, exit;
+            double entry_value, exit_value;
+        };
+        const std::vector<double> &close = symbol.candles.close;
+        size_t n = close.size();
+        std::vector<double> positions(n), returns(n), equity(n);
+        std::vector<Trade> trades;
+        double position = 0.0, value = 1.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double bar = i > 0 ? position * (close[i] / close[i - 1] - 1.0) : 0.0;
+            double target = position;
+            if (symbol.indicators.signal[i] != 0)
+            {
+                double size = config.strength_sizing && symbol.indicators.strength[i] < 2 ? 0.5 : 1.0;
+                target = symbol.indicators.signal[i] > 0 ? size : (config.allow_short ? -size : 0.0);
+            }
+            returns[i] = (1.0 + bar) * (1.0 - config.cost_rate * std::fabs(target - position)) - 1.0;
+            value *= 1.0 + returns[i];
+            equity[i] = value;
+            bool sign_change = (position > 0.0) != (target > 0.0) || (position < 0.0) != (target < 0.0);
+            if (position != 0.0 && sign_change)
+            {
+                trades.back().exit = i;
+                trades.back().exit_value = value;
+            }
+            if (target != 0.0 && (position == 0.0 || sign_change))
+            {
+                trades.push_back(Trade{i, n, value, 0.0});
+            }
+            positions[i] = position = target;
+        }
+        if (!trades.empty() && trades.back().exit == n)
+        {
+            trades.back().exit_value = value;
+        }
+
+        BacktestResult result;
+        result.bars = n;
+        result.final_equity = value;
+        result.total_return = value - 1.0;
+        double peak = 1.0, mean = 0.0, variance = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            peak = std::max(peak, equity[i]);
+            result.max_drawdown = std::max(result.max_drawdown, 1.0 - equity[i] / peak);
+            result.turnover += std::fabs(positions[i] - (i > 0 ? positions[i - 1] : 0.0));
+            result.exposure += (i > 0 && positions[i - 1] != 0.0) ? 1.0 : 0.0;
+            mean += returns[i];
+        }
+        mean /= n;
+        for (double r : returns)
+        {
+            variance += (r - mean) * (r - mean);
+        }
+        double stddev = std::sqrt(variance / n);
+        result.exposure /= n;
+        result.volatility = stddev * std::sqrt(config.periods_per_year);
+        result.sharpe = stddev > 0.0 ? mean / stddev * std::sqrt(config.periods_per_year) : 0.0;
+        result.annualized_return = std::pow(value, config.periods_per_year / n) - 1.0;
+        result.trades = static_cast<int>(trades.size());
+        for (const Trade &trade : trades)
+        {
+            result.winning_trades += trade.exit_value > trade.entry_value;
+        }
+        result.hit_rate = trades.empty() ? 0.0 : static_cast<double>(result.winning_trades) / trades.size();
+        return result;
+    }
+
+    bool close(double a, double b)
+    {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+    }
+
+    bool sameResult(const BacktestResult &a, const BacktestResult &b)
+    {
+        return a.bars == b.bars && a.trades == b.trades && a.winning_trades == b.winning_trades &&
+               close(a.final_equity, b.final_equity) && close(a.max_drawdown, b.max_drawdown) &&
+               close(a.turnover, b.turnover) && close(a.exposure, b.exposure) &&
+               close(a.volatility, b.volatility) && close(a.sharpe, b.sharpe) &&
+               close(a.annualized_return, b.annualized_return);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t symbols = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t years = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    size_t steps = years * 252;
+
+    SignalConfig config;
+    config.price_change_threshold = 0.005;
+    config.ema_fast = 12;
+    config.ema_slow = 26;
+    config.signal_period = 9;
+    config.rsi_period = 14;
+    const int lookback = config.ema_slow + config.signal_period - 1;
+    std::vector<Symbol> data = generateSymbols(symbols, steps, config, lookback);
+    std::vector<BacktestSeries> series;
+    for (const Symbol &symbol : data)
+    {
+        series.emplace_back(symbol.candles, symbol.indicators);
+    }
+
+    // 三種部位規則都須與直觀寫法一致
+    std::vector<BacktestConfig> configs(3);
+    configs[1].allow_short = true;
+    configs[2].allow_short = true;
+    configs[2].strength_sizing = true;
+    size_t mismatches = 0;
+    for (const BacktestConfig &backtest_config : configs)
+    {
+        Backtester backtester(backtest_config);
+        for (size_t s = 0; s < data.size(); ++s)
+        {
+            mismatches += !sameResult(backtester.run(series[s]), naiveBacktest(data[s], backtest_config));
+        }
+    }
+
+    Backtester backtester(configs[1]);
+    std::vector<BacktestResult> results(symbols);
+    double naive_ms = timeBestMs([&]
+                                 { for (size_t s = 0; s < symbols; ++s) results[s] = naiveBacktest(data[s], configs[1]); });
+    double single_ms = timeBestMs([&]
+                                  { for (size_t s = 0; s < symbols; ++s) results[s] = backtester.run(series[s]); });
+    ParallelBatch batch(threads);
+    double parallel_ms = timeBestMs([&]
+                                    { results = backtester.runBatch(series, batch); });
+
+    double mean_return = 0.0, mean_hit = 0.0;
+    for (const BacktestResult &result : results)
+    {
+        mean_return += result.annualized_return / symbols;
+        mean_hit += result.hit_rate / symbols;
+    }
+    double symbol_years = static_cast<double>(symbols * years);
+    std::cout << std::fixed << std::setprecision(2)
+              << "股票數 " << symbols << "，每檔 " << steps << " 根 K 線（" << years << " 年）\n"
+              << "逐筆交易寫法: " << naive_ms << " ms, " << symbol_years / naive_ms * 1000.0 << " 股票年/秒\n"
+              << "向量化單核:   " << single_ms << " ms, " << symbol_years / single_ms * 1000.0 << " 股票年/秒\n"
+              << "平行 " << batch.getThreadCount() << " 執行緒: " << parallel_ms << " ms, "
+              << symbol_years / parallel_ms * 1000.0 << " 股票年/秒\n"
+              << std::setprecision(4) << "平均年化報酬 " << mean_return << "，平均勝率 " << mean_hit << "\n"
+              << (mismatches == 0 ? "結果一致" : "結果不一致: " + std::to_string(mismatches)) << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include "Backtester.h"
+#include <cmath>
+#include "ParallelBatch.h"
+
+BacktestSeries::BacktestSeries(const CandleColumns &candles, const IndicatorColumns &indicators)
+    : close(candles.close.data()), signal(indicators.signal.data()), strength(indicators.strength.data()),
+      bars(candles.size() < indicators.size() ? candles.size() : indicators.size())
+{
+}
+
+Backtester::Backtester(const BacktestConfig &config) : config(config) {}
+
+BacktestResult Backtester::run(const BacktestSeries &series, double *equity) const
+{
+    BacktestResult result;
+    result.bars = series.bars;
+    if (series.bars == 0)
+    {
+        return result;
+    }
+
+    const double *close = series.close;
+    const signed char *signal = series.signal;
+    const signed char *strength = series.strength;
+    const double cost_rate = config.cost_rate;
+    const double short_side = config.allow_short ? -1.0 : 0.0;
+    const bool sizing = config.strength_sizing;
+
+    double value = 1.0, peak = 1.0, max_drawdown = 0.0;
+    double position = 0.0, turnover = 0.0;
+    double sum = 0.0, sum_squares = 0.0;
+    double entry_value = 1.0;
+    size_t held = 0;
+    int trades = 0, winning = 0;
+
+    for (size_t i = 0; i < series.bars; ++i)
+    {
+        // 前一收盤的部位承擔本根 K 線的漲跌；價格無效時視為無變動
+        double bar_return = 0.0;
+        if (i > 0 && close[i - 1] > 0.0 && std::isfinite(close[i - 1]) && std::isfinite(close[i]))
+        {
+            bar_return = position * (close[i] / close[i - 1] - 1.0);
+        }
+        held += position != 0.0;
+
+        // 本根收盤依訊號調整部位，換手成本於調整當下扣除
+        double target = position;
+        if (signal[i] != 0)
+        {
+            double size = sizing && strength[i] < 2 ? 0.5 : 1.0;
+            target = signal[i] > 0 ? size : short_side * size;
+        }
+        double change = std::fabs(target - position);
+        double net = (1.0 + bar_return) * (1.0 - cost_rate * change) - 1.0;
+        turnover += change;
+        value *= 1.0 + net;
+        sum += net;
+        sum_squares += net * net;
+
+        // 部位方向改變即結束一筆交易（加碼、減碼不算）
+        bool was_in = position != 0.0;
+        bool flipped = (position > 0.0) != (target > 0.0) || (position < 0.0) != (target < 0.0);
+        if (was_in && flipped)
+        {
+            ++trades;
+            winning += value > entry_value;
+        }
+        if (target != 0.0 && (!was_in || flipped))
+        {
+            entry_value = value;
+        }
+        position = target;
+
+        peak = value > peak ? value : peak;
+        double drawdown = 1.0 - value / peak;
+        max_drawdown = drawdown > max_drawdown ? drawdown : max_drawdown;
+        if (equity)
+        {
+            equity[i] = value;
+        }
+    }
+    if (position != 0.0)
+    {
+        ++trades;
+        winning += value > entry_value;
+    }
+
+    double n = static_cast<double>(series.bars);
+    double mean = sum / n;
+    double variance = sum_squares / n - mean * mean;
+    double stddev = variance > 0.0 ? std::sqrt(variance) : 0.0;
+    result.final_equity = value;
+    result.total_return = value - 1.0;
+    result.annualized_return = value > 0.0 ? std::pow(value, config.periods_per_year / n) - 1.0 : -1.0;
+    result.volatility = stddev * std::sqrt(config.periods_per_year);
+    result.sharpe = stddev > 0.0 ? mean / stddev * std::sqrt(config.periods_per_year) : 0.0;
+    result.max_drawdown = max_drawdown;
+    result.exposure = static_cast<double>(held) / n;
+    result.turnover = turnover;
+    result.trades = trades;
+    result.winning_trades = winning;
+    result.hit_rate = trades > 0 ? static_cast<double>(winning) / trades : 0.0;
+    return result;
+}
+
+BacktestResult Backtester::run(const CandleColumns &candles, const IndicatorColumns &indicators) const
+{
+    return run(BacktestSeries(candles, indicators));
+}
+
+std::vector<BacktestResult> Backtester::runBatch(const std::vector<BacktestSeries> &series, const ParallelBatch &batch) const
+{
+    std::vector<BacktestResult> results(series.size());
+    batch.run(
+        series.size(),
+        [&](size_t i)
+        { results[i] = run(series[i]); },
+        [](size_t) {});
+    return results;
+}
@@ -0,0 +1,66 @@
+#ifndef BACKTESTER_H
+#define BACKTESTER_H
+#include <cstddef>
+#include <vector>
+#include "IndicatorPipeline.h"
+
+class ParallelBatch;
+
+// 回測設定
+struct BacktestConfig
+{
+    double cost_rate = 0.001;       // 每單位換手的手續費與滑價（佔部位價值比例）
+    bool allow_short = false;       // 賣出訊號時放空，否則只出場
+    bool strength_sizing = false;   // 依訊號強度決定部位：強 1.0、中 0.5
+    double periods_per_year = 252.0;
+};
+
+// 單一股票的回測結果；報酬、回撤皆為比例（0.05 = 5%）
+struct BacktestResult
+{
+    size_t bars = 0;
+    double final_equity = 1.0;
+    double total_return = 0.0;
+    double annualized_return = 0.0;
+    double volatility = 0.0; // 年化
+    double sharpe = 0.0;
+    double max_drawdown = 0.0;
+    double exposure = 0.0; // 持有部位的 K 線比例
+    double turnover = 0.0; // 部位變動量總和
+    int trades = 0;        // 已結束的交易（期末未平倉者以最後收盤計）
+    int winning_trades = 0;
+    double hit_rate = 0.0;
+};
+
+// 一檔股票的輸入欄位（不擁有資料），三個欄位長度皆為 bars
+struct BacktestSeries
+{
+    const double *close = nullptr;
+    const signed char *signal = nullptr;   // 編碼同 SignalCode
+    const signed char *strength = nullptr;
+    size_t bars = 0;
+
+    BacktestSeries() = default;
+    BacktestSeries(const CandleColumns &candles, const IndicatorColumns &indicators);
+};
+
+// 向量化回測：單次走訪收盤價與訊號欄位，同時累計權益、報酬、回撤、勝率與換手率，
+// 過程中不配置記憶體。第 i 根 K 線收盤出現的訊號於該收盤調整部位，自 i+1 起承擔漲跌
+class Backtester
+{
+public:
+    explicit Backtester(const BacktestConfig &config = BacktestConfig());
+
+    // equity 不為 nullptr 時寫入每根 K 線收盤後的權益（長度 bars）
+    BacktestResult run(const BacktestSeries &series, double *equity = nullptr) const;
+    BacktestResult run(const CandleColumns &candles, const IndicatorColumns &indicators) const;
+    // 多檔股票平行回測，結果與輸入順序相同
+    std::vector<BacktestResult> runBatch(const std::vector<BacktestSeries> &series, const ParallelBatch &batch) const;
+
+    const BacktestConfig &getConfig() const { return config; }
+
+private:
+    BacktestConfig config;
+};
+
+#endif
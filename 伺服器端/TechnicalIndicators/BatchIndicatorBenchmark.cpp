@@ -0,0 +1,115 @@
+// 跨股票批次指標引擎的效能比較：逐檔呼叫 Tech_Analysis 與 BatchIndicatorEngine 各指令集版本
+// 用法：BatchIndicatorBenchmark [股票數=512] [天數=5000]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include "Tech_Analysis.h"
+#include "BatchIndicators.h"
+#include "SyntheticCandles.h"
+
+namespace
+{
+    // 幾何布朗運動產生的模擬收盤價
+    std::vector<std::vector<double>> generateCloses(size_t symbols, size_t steps)
+    {
+        SyntheticCandles generator(20240601);
+        std::vector<std::vector<double>> closes(symbols, std::vector<double>(steps));
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            generator.reset(SyntheticCandles::startPrice(s));
+            for (size_t t = 0; t < steps; ++t)
+            {
+                closes[s][t] = std::round(generator.nextClose() * 10000.0) / 10000.0;
+            }
+        }
+        return closes;
+    }
+
+    double maxDiff(const std::vector<std::vector<double>> &expected, const BatchSeries &actual)
+    {
+        double diff = 0.0;
+        for (size_t s = 0; s < expected.size(); ++s)
+        {
+            for (size_t t = 0; t < expected[s].size(); ++t)
+            {
+                diff = std::max(diff, std::abs(expected[s][t] - actual.at(t, s)));
+            }
+        }
+        return diff;
+    }
+
+    void report(const std::string &indicator, const std::string &kernel, double ms, double baseline_ms, size_t bars, double diff)
+    {
+        std::cout << std::left << std::setw(8) << indicator << std::setw(12) << kernel
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms"
+                  << std::setw(10) << (ms * 1e6 / bars) << " ns/bar"
+                  << std::setw(8) << (baseline_ms / ms) << "x"
+                  << "   max_diff=" << std::scientific << std::setprecision(2) << diff << std::defaultfloat << "\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t symbols = (argc > 1) ? std::stoul(argv[1]) : 512;
+    size_t steps = (argc > 2) ? std::stoul(argv[2]) : 5000;
+    size_t bars = symbols * steps;
+    std::cout << "symbols=" << symbols << " steps=" << steps << " best kernel="
+              << BatchIndicatorEngine::kernelName(BatchIndicatorEngine::bestKernel()) << "\n";
+
+    std::vector<std::vector<double>> closes = generateCloses(symbols, steps);
+    BatchSeries batch = BatchSeries::fromColumns(closes);
+    SignalConfig config;
+
+    // 逐檔計算作為基準與正確性參考
+    std::vector<std::vector<double>> ma_ref(symbols), macd_ref(symbols), signal_ref(symbols), hist_ref(symbols), rsi_ref(symbols);
+    double ma_base = timeBestMs([&]
+                                { for (size_t s = 0; s < symbols; ++s) ma_ref[s] = Tech_Analysis::movingAverages(closes[s], {20})[0]; });
+    double macd_base = timeBestMs([&]
+                                  {
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            std::vector<MACDResult> series = MACDResult::macdSeries(closes[s], config);
+            macd_ref[s].resize(steps);
+            signal_ref[s].resize(steps);
+            hist_ref[s].resize(steps);
+            for (size_t t = 0; t < steps; ++t)
+            {
+                macd_ref[s][t] = series[t].macdLine;
+                signal_ref[s][t] = series[t].signalLine;
+                hist_ref[s][t] = series[t].histogram;
+            }
+        } });
+    double rsi_base = timeBestMs([&]
+                                 { for (size_t s = 0; s < symbols; ++s) rsi_ref[s] = RSIResult::rsiSeries(closes[s], config.rsi_period, config); });
+    report("MA20", "per-symbol", ma_base, ma_base, bars, 0.0);
+    report("MACD", "per-symbol", macd_base, macd_base, bars, 0.0);
+    report("RSI14", "per-symbol", rsi_base, rsi_base, bars, 0.0);
+
+    for (auto kernel : {BatchIndicatorEngine::Kernel::Scalar, BatchIndicatorEngine::Kernel::SSE2, BatchIndicatorEngine::Kernel::AVX2})
+    {
+        if (!BatchIndicatorEngine::isSupported(kernel))
+        {
+            continue;
+        }
+        BatchIndicatorEngine engine(kernel);
+        std::string name = std::string("batch-") + BatchIndicatorEngine::kernelName(kernel);
+        BatchSeries ma, macd_line, signal_line, histogram, rsi;
+
+        double ma_ms = timeBestMs([&]
+                                  { engine.movingAverage(batch, 20, ma); });
+        report("MA20", name, ma_ms, ma_base, bars, maxDiff(ma_ref, ma));
+
+        double macd_ms = timeBestMs([&]
+                                    { engine.macd(batch, config, macd_line, signal_line, histogram); });
+        double macd_diff = std::max({maxDiff(macd_ref, macd_line), maxDiff(signal_ref, signal_line), maxDiff(hist_ref, histogram)});
+        report("MACD", name, macd_ms, macd_base, bars, macd_diff);
+
+        double rsi_ms = timeBestMs([&]
+                                   { engine.rsi(batch, config.rsi_period, config.rsi_mode, rsi); });
+        report("RSI14", name, rsi_ms, rsi_base, bars, maxDiff(rsi_ref, rsi));
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include "BatchIndicators.h"
+#include <algorithm>
+#include <stdexcept>
+#include "BatchKernels.h"
+
+#ifdef BATCH_X86_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // 純量版本：一次處理一檔股票，也用來處理不足一個向量寬度的剩餘股票
+    struct ScalarOps
+    {
+        typedef double vec;
+        typedef bool mask;
+        static const size_t width = 1;
+
+        static vec zero() { return 0.0; }
+        static vec set1(double v) { return v; }
+        static vec load(const double *p) { return *p; }
+        static void store(double *p, vec v) { *p = v; }
+        static vec add(vec a, vec b) { return a + b; }
+        static vec sub(vec a, vec b) { return a - b; }
+        static vec mul(vec a, vec b) { return a * b; }
+        static vec div(vec a, vec b) { return a / b; }
+        static vec max(vec a, vec b) { return a > b ? a : b; }
+        static mask gt(vec a, vec b) { return a > b; }
+        static mask ge(vec a, vec b) { return a >= b; }
+        static mask le(vec a, vec b) { return a <= b; }
+        static mask eq(vec a, vec b) { return a == b; }
+        static mask and_(mask a, mask b) { return a && b; }
+        static mask not_(mask a) { return !a; }
+        static vec select(mask m, vec a, vec b) { return m ? a : b; }
+    };
+
+#ifdef BATCH_X86_KERNELS
+    // SSE2 為 x86-64 的基本指令集，一次處理 2 檔股票
+    struct SSE2Ops
+    {
+        typedef __m128d vec;
+        typedef __m128d mask;
+        static const size_t width = 2;
+
+        static vec zero() { return _mm_setzero_pd(); }
+        static vec set1(double v) { return _mm_set1_pd(v); }
+        static vec load(const double *p) { return _mm_loadu_pd(p); }
+        static void store(double *p, vec v) { _mm_storeu_pd(p, v); }
+        static vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+        static vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+        static vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+        static vec div(vec a, vec b) { return _mm_div_pd(a, b); }
+        static vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+        static mask gt(vec a, vec b) { return _mm_cmpgt_pd(a, b); }
+        static mask ge(vec a, vec b) { return _mm_cmpge_pd(a, b); }
+        static mask le(vec a, vec b) { return _mm_cmple_pd(a, b); }
+        static mask eq(vec a, vec b) { return _mm_cmpeq_pd(a, b); }
+        static mask and_(mask a, mask b) { return _mm_and_pd(a, b); }
+        static mask not_(mask a) { return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi32(-1))); }
+        static vec select(mask m, vec a, vec b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+    };
+#endif
+}
+
+const BatchKernelTable &scalarBatchKernels()
+{
+    return makeBatchKernelTable<ScalarOps>();
+}
+
+#ifdef BATCH_X86_KERNELS
+const BatchKernelTable &sse2BatchKernels()
+{
+    return makeBatchKernelTable<SSE2Ops>();
+}
+#endif
+
+namespace
+{
+    const BatchKernelTable &kernelTable(BatchIndicatorEngine::Kernel kernel)
+    {
+#ifdef BATCH_X86_KERNELS
+        switch (kernel)
+        {
+        case BatchIndicatorEngine::Kernel::AVX2:
+            return avx2BatchKernels();
+        case BatchIndicatorEngine::Kernel::SSE2:
+            return sse2BatchKernels();
+        default:
+            break;
+        }
+#endif
+        return scalarBatchKernels();
+    }
+
+    // 向量寬度整數倍的股票交給所選指令集，剩餘的股票改用純量核心；
+    // scratch 依核心需要的狀態陣列數配置，每個時間步連續讀寫
+    template <class Body>
+    void forEachLaneRange(const BatchKernelTable &table, size_t symbols, size_t states, Body body)
+    {
+        std::vector<double> scratch(symbols * states);
+        size_t vector_end = symbols - symbols % table.width;
+        if (vector_end > 0)
+        {
+            body(table, 0, vector_end, scratch.data());
+        }
+        if (vector_end < symbols)
+        {
+            body(scalarBatchKernels(), vector_end, symbols, scratch.data());
+        }
+    }
+}
+
+BatchSeries::BatchSeries(size_t symbols, size_t steps)
+    : symbols(symbols), steps(steps), values(symbols * steps, 0.0)
+{
+}
+
+BatchSeries BatchSeries::fromColumns(const std::vector<std::vector<double>> &columns)
+{
+    size_t steps = columns.empty() ? 0 : columns.front().size();
+    BatchSeries batch(columns.size(), steps);
+    for (size_t s = 0; s < columns.size(); ++s)
+    {
+        if (columns[s].size() != steps)
+        {
+            throw std::invalid_argument("BatchSeries::fromColumns: series lengths differ");
+        }
+        for (size_t t = 0; t < steps; ++t)
+        {
+            batch.at(t, s) = columns[s][t];
+        }
+    }
+    return batch;
+}
+
+std::vector<double> BatchSeries::column(size_t s) const
+{
+    std::vector<double> result(steps);
+    for (size_t t = 0; t < steps; ++t)
+    {
+        result[t] = at(t, s);
+    }
+    return result;
+}
+
+BatchIndicatorEngine::Kernel BatchIndicatorEngine::bestKernel()
+{
+    if (isSupported(Kernel::AVX2))
+    {
+        return Kernel::AVX2;
+    }
+    if (isSupported(Kernel::SSE2))
+    {
+        return Kernel::SSE2;
+    }
+    return Kernel::Scalar;
+}
+
+bool BatchIndicatorEngine::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef BATCH_X86_KERNELS
+    case Kernel::AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    case Kernel::SSE2:
+        return true;
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const char *BatchIndicatorEngine::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::AVX2:
+        return "avx2";
+    case Kernel::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+BatchIndicatorEngine::BatchIndicatorEngine(Kernel kernel)
+    : kernel(isSupported(kernel) ? kernel : Kernel::Scalar)
+{
+}
+
+void BatchIndicatorEngine::movingAverage(const BatchSeries &closes, int period, BatchSeries &out) const
+{
+    out = BatchSeries(closes.symbols, closes.steps);
+    forEachLaneRange(kernelTable(kernel), closes.symbols, kBatchMovingAverageStates,
+                     [&](const BatchKernelTable &table, size_t begin, size_t end, double *scratch)
+                     { table.moving_average(closes.values.data(), out.values.data(), closes.steps, closes.symbols,
+                                            begin, end, scratch, period); });
+}
+
+void BatchIndicatorEngine::macd(const BatchSeries &closes, const SignalConfig &config,
+                                BatchSeries &macd_line, BatchSeries &signal_line, BatchSeries &histogram) const
+{
+    macd_line = BatchSeries(closes.symbols, closes.steps);
+    signal_line = BatchSeries(closes.symbols, closes.steps);
+    histogram = BatchSeries(closes.symbols, closes.steps);
+    BatchMACDParams params = {config.ema_fast, config.ema_slow, config.signal_period};
+    forEachLaneRange(kernelTable(kernel), closes.symbols, kBatchMACDStates,
+                     [&](const BatchKernelTable &table, size_t begin, size_t end, double *scratch)
+                     { table.macd(closes.values.data(), macd_line.values.data(), signal_line.values.data(), histogram.values.data(),
+                                  closes.steps, closes.symbols, begin, end, scratch, params); });
+}
+
+void BatchIndicatorEngine::rsi(const BatchSeries &closes, int period, RSIMode mode, BatchSeries &out) const
+{
+    out = BatchSeries(closes.symbols, closes.steps);
+    bool wilder = (mode == RSIMode::Wilder);
+    forEachLaneRange(kernelTable(kernel), closes.symbols, kBatchRSIStates,
+                     [&](const BatchKernelTable &table, size_t begin, size_t end, double *scratch)
+                     { table.rsi(closes.values.data(), out.values.data(), closes.steps, closes.symbols,
+                                 begin, end, scratch, period, wilder); });
+}
@@ -0,0 +1,57 @@
+#ifndef BATCH_INDICATORS_H
+#define BATCH_INDICATORS_H
+#include <vector>
+#include <cstddef>
+#include "TradeSignal.h" // 包含 SignalConfig 與 RSIMode 定義
+
+// 多檔股票對齊同一交易日曆的序列：time-major、symbol-minor 佈局，
+// 第 t 天第 s 檔股票位於 values[t * symbols + s]，同一天的所有股票連續存放
+struct BatchSeries
+{
+    size_t symbols = 0;
+    size_t steps = 0;
+    std::vector<double> values;
+
+    BatchSeries() = default;
+    BatchSeries(size_t symbols, size_t steps);
+
+    double &at(size_t t, size_t s) { return values[t * symbols + s]; }
+    double at(size_t t, size_t s) const { return values[t * symbols + s]; }
+    // 各股票序列長度必須相同
+    static BatchSeries fromColumns(const std::vector<std::vector<double>> &columns);
+    std::vector<double> column(size_t s) const;
+};
+
+// 跨股票批次指標引擎：EMA/RSI 等遞推在時間上無法向量化，
+// 改為每個時間步以 SIMD 同時推進多檔股票，結果與 Tech_Analysis 的單檔版本在誤差範圍內一致
+class BatchIndicatorEngine
+{
+public:
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // 執行期偵測 CPU 支援的最佳指令集
+    static Kernel bestKernel();
+    static bool isSupported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+    explicit BatchIndicatorEngine(Kernel kernel = bestKernel());
+    Kernel getKernel() const { return kernel; }
+
+    // 對應 Tech_Analysis::movingAverages 的單一週期版本
+    void movingAverage(const BatchSeries &closes, int period, BatchSeries &out) const;
+    // 對應 MACDResult::macdSeries
+    void macd(const BatchSeries &closes, const SignalConfig &config,
+              BatchSeries &macd_line, BatchSeries &signal_line, BatchSeries &histogram) const;
+    // 對應 RSIResult::rsiSeries
+    void rsi(const BatchSeries &closes, int period, RSIMode mode, BatchSeries &out) const;
+
+private:
+    Kernel kernel;
+};
+
+#endif
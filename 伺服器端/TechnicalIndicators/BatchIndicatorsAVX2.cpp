@@ -0,0 +1,48 @@
+// AVX2 版本的批次指標核心：整個翻譯單元以 avx2 目標編譯，
+// 只在 BatchIndicatorEngine 於執行期確認 CPU 支援 AVX2 後才會被呼叫
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// 核心樣板必須在 target 切換之後才定義，才能與 AVX2 運算一起內聯
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#include "BatchKernels.h"
+
+namespace
+{
+    // 一次處理 4 檔股票
+    struct AVX2Ops
+    {
+        typedef __m256d vec;
+        typedef __m256d mask;
+        static const size_t width = 4;
+
+        static vec zero() { return _mm256_setzero_pd(); }
+        static vec set1(double v) { return _mm256_set1_pd(v); }
+        static vec load(const double *p) { return _mm256_loadu_pd(p); }
+        static void store(double *p, vec v) { _mm256_storeu_pd(p, v); }
+        static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+        static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+        static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+        static vec div(vec a, vec b) { return _mm256_div_pd(a, b); }
+        static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+        static mask gt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static mask ge(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+        static mask le(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+        static mask eq(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static mask and_(mask a, mask b) { return _mm256_and_pd(a, b); }
+        static mask not_(mask a) { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))); }
+        static vec select(mask m, vec a, vec b) { return _mm256_blendv_pd(b, a, m); }
+    };
+}
+
+const BatchKernelTable &avx2BatchKernels()
+{
+    return makeBatchKernelTable<AVX2Ops>();
+}
+
+#pragma GCC pop_options
+
+#endif
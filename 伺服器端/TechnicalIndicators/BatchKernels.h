@@ -0,0 +1,352 @@
+#ifndef BATCH_KERNELS_H
+#define BATCH_KERNELS_H
+#include <cstddef>
+
+// 批次指標核心，僅供 BatchIndicators.cpp 與 BatchIndicatorsAVX2.cpp 內部使用。
+// 核心以向量運算型別 V 撰寫一次，每個時間步同時推進 V::width 檔股票；
+// 各指令集在自己的翻譯單元中實例化，匿名命名空間避免不同指令集的實例被連結器合併。
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_X86_KERNELS 1
+#endif
+
+struct BatchMACDParams
+{
+    int ema_fast, ema_slow, signal_period;
+};
+
+// 單一指令集的核心函式表。每個核心以時間為外層迴圈，每個時間步依序推進 [lane_begin, lane_end)
+// 內的所有股票（lane_end - lane_begin 必須是 width 的倍數），各股票的遞推狀態存放在
+// 呼叫端提供的 scratch 中（每個狀態一段 lane_end - lane_begin 長的陣列），讀寫皆為連續記憶體
+struct BatchKernelTable
+{
+    size_t width;
+    void (*moving_average)(const double *in, double *out, size_t steps, size_t stride,
+                           size_t lane_begin, size_t lane_end, double *scratch, int period);
+    void (*macd)(const double *in, double *macd_out, double *signal_out, double *hist_out, size_t steps, size_t stride,
+                 size_t lane_begin, size_t lane_end, double *scratch, const BatchMACDParams &params);
+    void (*rsi)(const double *in, double *out, size_t steps, size_t stride,
+                size_t lane_begin, size_t lane_end, double *scratch, int period, bool wilder);
+};
+
+// 各核心需要的 scratch 狀態陣列數
+const size_t kBatchMovingAverageStates = 2;
+const size_t kBatchMACDStates = 5;
+const size_t kBatchRSIStates = 8;
+
+const BatchKernelTable &scalarBatchKernels();
+#ifdef BATCH_X86_KERNELS
+const BatchKernelTable &sse2BatchKernels();
+const BatchKernelTable &avx2BatchKernels();
+#endif
+
+namespace
+{
+    // 價格有效：大於 0 且為有限值（x - x 對 Inf/NaN 會得到 NaN）
+    template <class V>
+    inline typename V::mask validPrice(typename V::vec x)
+    {
+        return V::and_(V::gt(x, V::zero()), V::eq(V::sub(x, x), V::zero()));
+    }
+
+    template <class V>
+    inline typename V::vec countIf(typename V::mask m)
+    {
+        return V::select(m, V::set1(1.0), V::zero());
+    }
+
+    template <class V>
+    void movingAverageKernel(const double *in, double *out, size_t steps, size_t stride,
+                             size_t lane_begin, size_t lane_end, double *scratch, int period)
+    {
+        typedef typename V::vec vec;
+        typedef typename V::mask mask;
+        const size_t lanes = lane_end - lane_begin;
+        const size_t p = static_cast<size_t>(period);
+        const vec divisor = V::set1(period);
+        double *sums = scratch, *bads = scratch + lanes;
+        for (size_t j = 0; j < 2 * lanes; ++j)
+        {
+            scratch[j] = 0.0;
+        }
+
+        for (size_t t = 0; t < steps; ++t)
+        {
+            const double *row = in + t * stride + lane_begin;
+            const double *old_row = (t >= p) ? in + (t - p) * stride + lane_begin : nullptr;
+            double *out_row = out + t * stride + lane_begin;
+            for (size_t j = 0; j < lanes; j += V::width)
+            {
+                vec sum = V::load(sums + j), bad = V::load(bads + j);
+                vec x = V::load(row + j);
+                mask ok = validPrice<V>(x);
+                sum = V::add(sum, V::select(ok, x, V::zero()));
+                bad = V::add(bad, countIf<V>(V::not_(ok)));
+                if (old_row)
+                {
+                    vec old = V::load(old_row + j);
+                    mask old_ok = validPrice<V>(old);
+                    sum = V::sub(sum, V::select(old_ok, old, V::zero()));
+                    bad = V::sub(bad, countIf<V>(V::not_(old_ok)));
+                }
+                V::store(sums + j, sum);
+                V::store(bads + j, bad);
+
+                vec result = V::zero();
+                if (t + 1 >= p)
+                {
+                    result = V::select(V::eq(bad, V::zero()), V::div(sum, divisor), V::zero());
+                }
+                V::store(out_row + j, result);
+            }
+        }
+    }
+
+    // 與 MACDState 相同的遞推：SMA 種子的快慢 EMA，訊號線為視窗平均的衰減項加上 EMA 尾項
+    template <class V>
+    void macdKernel(const double *in, double *macd_out, double *signal_out, double *hist_out, size_t steps, size_t stride,
+                    size_t lane_begin, size_t lane_end, double *scratch, const BatchMACDParams &params)
+    {
+        typedef typename V::vec vec;
+        typedef typename V::mask mask;
+        const size_t lanes = lane_end - lane_begin;
+        const size_t fast_period = static_cast<size_t>(params.ema_fast);
+        const size_t slow_period = static_cast<size_t>(params.ema_slow);
+        const size_t signal_period = static_cast<size_t>(params.signal_period);
+        const double k_fast = 2.0 / (params.ema_fast + 1.0);
+        const double k_slow = 2.0 / (params.ema_slow + 1.0);
+        const double k_signal = 2.0 / (params.signal_period + 1.0);
+        const vec kf = V::set1(k_fast), kf_rest = V::set1(1.0 - k_fast);
+        const vec ks = V::set1(k_slow), ks_rest = V::set1(1.0 - k_slow);
+        const vec ksig = V::set1(k_signal), ksig_rest = V::set1(1.0 - k_signal);
+        const vec fast_divisor = V::set1(params.ema_fast), slow_divisor = V::set1(params.ema_slow);
+        const vec signal_divisor = V::set1(params.signal_period);
+        const vec one = V::set1(1.0);
+        const size_t signal_sma_index = slow_period + signal_period - 2;
+
+        double *ema_fasts = scratch, *ema_slows = scratch + lanes, *window_sums = scratch + 2 * lanes;
+        double *signal_emas = scratch + 3 * lanes, *alives = scratch + 4 * lanes; // alive: 至今所有輸入皆有效為 1
+        for (size_t j = 0; j < 4 * lanes; ++j)
+        {
+            scratch[j] = 0.0;
+        }
+        for (size_t j = 0; j < lanes; ++j)
+        {
+            alives[j] = 1.0;
+        }
+        double decay = 1.0;
+
+        for (size_t t = 0; t < steps; ++t)
+        {
+            size_t at = t * stride + lane_begin;
+            if (t == signal_sma_index)
+            {
+                decay = 1.0;
+            }
+            else if (t > signal_sma_index)
+            {
+                decay *= (1.0 - k_signal);
+            }
+            const vec decay_v = V::set1(decay);
+
+            for (size_t j = 0; j < lanes; j += V::width)
+            {
+                vec x = V::load(in + at + j);
+                mask alive = V::and_(V::eq(V::load(alives + j), one), validPrice<V>(x));
+                V::store(alives + j, V::select(alive, one, V::zero()));
+
+                vec ema_fast = V::load(ema_fasts + j), ema_slow = V::load(ema_slows + j);
+                if (t < fast_period)
+                {
+                    ema_fast = V::add(ema_fast, x);
+                    if (t + 1 == fast_period)
+                    {
+                        ema_fast = V::div(ema_fast, fast_divisor);
+                    }
+                }
+                else
+                {
+                    ema_fast = V::add(V::mul(x, kf), V::mul(ema_fast, kf_rest));
+                }
+                if (t < slow_period)
+                {
+                    ema_slow = V::add(ema_slow, x);
+                    if (t + 1 == slow_period)
+                    {
+                        ema_slow = V::div(ema_slow, slow_divisor);
+                    }
+                }
+                else
+                {
+                    ema_slow = V::add(V::mul(x, ks), V::mul(ema_slow, ks_rest));
+                }
+                V::store(ema_fasts + j, ema_fast);
+                V::store(ema_slows + j, ema_slow);
+
+                if (t + 1 < slow_period)
+                {
+                    V::store(macd_out + at + j, V::zero());
+                    V::store(signal_out + at + j, V::zero());
+                    V::store(hist_out + at + j, V::zero());
+                    continue;
+                }
+
+                vec fast = (t + 1 >= fast_period) ? ema_fast : V::zero();
+                vec macd_line = V::sub(fast, ema_slow);
+
+                // 視窗移出的值直接從已寫出的 MACD 欄位讀回；仍有效的股票當時必然也有效
+                vec window_sum = V::add(V::load(window_sums + j), macd_line);
+                if (t >= slow_period - 1 + signal_period)
+                {
+                    window_sum = V::sub(window_sum, V::load(macd_out + (t - signal_period) * stride + lane_begin + j));
+                }
+                V::store(window_sums + j, window_sum);
+
+                vec signal_line = V::zero();
+                if (t == signal_sma_index)
+                {
+                    V::store(signal_emas + j, V::zero());
+                    signal_line = V::div(window_sum, signal_divisor);
+                }
+                else if (t > signal_sma_index)
+                {
+                    vec signal_ema = V::add(V::mul(macd_line, ksig), V::mul(V::load(signal_emas + j), ksig_rest));
+                    V::store(signal_emas + j, signal_ema);
+                    signal_line = V::add(V::mul(V::div(window_sum, signal_divisor), decay_v), signal_ema);
+                }
+                vec histogram = V::sub(macd_line, signal_line);
+
+                V::store(macd_out + at + j, V::select(alive, macd_line, V::zero()));
+                V::store(signal_out + at + j, V::select(alive, signal_line, V::zero()));
+                V::store(hist_out + at + j, V::select(alive, histogram, V::zero()));
+            }
+        }
+    }
+
+    // 與 RSIResult::fromAverages 相同的換算，不合法的結果為 0
+    template <class V>
+    inline typename V::vec rsiFromAverages(typename V::vec avg_gain, typename V::vec avg_loss)
+    {
+        typedef typename V::vec vec;
+        const vec hundred = V::set1(100.0);
+        vec rs = V::div(avg_gain, avg_loss);
+        vec rsi = V::sub(hundred, V::div(hundred, V::add(V::set1(1.0), rs)));
+        vec no_loss = V::select(V::eq(avg_gain, V::zero()), V::zero(), hundred);
+        rsi = V::select(V::eq(avg_loss, V::zero()), no_loss, rsi);
+        return V::select(V::and_(V::ge(rsi, V::zero()), V::le(rsi, hundred)), rsi, V::zero());
+    }
+
+    // 單筆漲跌拆成漲幅、跌幅與有效旗標
+    template <class V>
+    inline void splitChange(typename V::vec diff, typename V::vec &gain, typename V::vec &loss, typename V::mask &ok)
+    {
+        ok = V::eq(V::sub(diff, diff), V::zero());
+        gain = V::select(ok, V::max(diff, V::zero()), V::zero());
+        loss = V::select(ok, V::max(V::sub(V::zero(), diff), V::zero()), V::zero());
+    }
+
+    // 與 RSIState 相同：Simple 為視窗漲跌總和的平均，Wilder 以前 period 筆平均為種子後平滑
+    template <class V>
+    void rsiKernel(const double *in, double *out, size_t steps, size_t stride,
+                   size_t lane_begin, size_t lane_end, double *scratch, int period, bool wilder)
+    {
+        typedef typename V::vec vec;
+        typedef typename V::mask mask;
+        const size_t lanes = lane_end - lane_begin;
+        const size_t p = static_cast<size_t>(period);
+        const vec divisor = V::set1(period), rest = V::set1(period - 1);
+        double *gains = scratch, *losses = scratch + lanes;
+        double *gain_nonzeros = scratch + 2 * lanes, *loss_nonzeros = scratch + 3 * lanes, *bads = scratch + 4 * lanes;
+        double *counts = scratch + 5 * lanes, *avg_gains = scratch + 6 * lanes, *avg_losses = scratch + 7 * lanes;
+        for (size_t j = 0; j < 8 * lanes; ++j)
+        {
+            scratch[j] = 0.0;
+        }
+
+        for (size_t t = 0; t < steps; ++t)
+        {
+            double *out_row = out + t * stride + lane_begin;
+            if (t == 0)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    out_row[j] = 0.0;
+                }
+                continue;
+            }
+            const double *row = in + t * stride + lane_begin;
+            const double *prev_row = row - stride;
+            const double *old_row = (t > p) ? in + (t - p) * stride + lane_begin : nullptr;
+
+            for (size_t j = 0; j < lanes; j += V::width)
+            {
+                vec gain, loss;
+                mask ok;
+                splitChange<V>(V::sub(V::load(row + j), V::load(prev_row + j)), gain, loss, ok);
+                vec gain_total = V::add(V::load(gains + j), gain);
+                vec loss_total = V::add(V::load(losses + j), loss);
+                vec gain_nonzero = V::add(V::load(gain_nonzeros + j), countIf<V>(V::gt(gain, V::zero())));
+                vec loss_nonzero = V::add(V::load(loss_nonzeros + j), countIf<V>(V::gt(loss, V::zero())));
+                vec bad = V::add(V::load(bads + j), countIf<V>(V::not_(ok)));
+
+                if (old_row)
+                {
+                    vec old_gain, old_loss;
+                    mask old_ok;
+                    splitChange<V>(V::sub(V::load(old_row + j), V::load(old_row - stride + j)), old_gain, old_loss, old_ok);
+                    gain_total = V::sub(gain_total, old_gain);
+                    loss_total = V::sub(loss_total, old_loss);
+                    gain_nonzero = V::sub(gain_nonzero, countIf<V>(V::gt(old_gain, V::zero())));
+                    loss_nonzero = V::sub(loss_nonzero, countIf<V>(V::gt(old_loss, V::zero())));
+                    bad = V::sub(bad, countIf<V>(V::not_(old_ok)));
+                }
+                V::store(gains + j, gain_total);
+                V::store(losses + j, loss_total);
+                V::store(gain_nonzeros + j, gain_nonzero);
+                V::store(loss_nonzeros + j, loss_nonzero);
+                V::store(bads + j, bad);
+
+                // 視窗內沒有任何漲（跌）時總和精確為 0，避免加減殘差
+                vec gain_sum = V::select(V::eq(gain_nonzero, V::zero()), V::zero(), gain_total);
+                vec loss_sum = V::select(V::eq(loss_nonzero, V::zero()), V::zero(), loss_total);
+
+                vec result = V::zero();
+                if (wilder)
+                {
+                    vec count = V::select(ok, V::add(V::load(counts + j), V::set1(1.0)), V::zero());
+                    mask seed = V::eq(count, divisor);
+                    mask smooth = V::gt(count, divisor);
+                    vec avg_gain = V::load(avg_gains + j), avg_loss = V::load(avg_losses + j);
+                    avg_gain = V::select(seed, V::div(gain_sum, divisor),
+                                         V::select(smooth, V::div(V::add(V::mul(avg_gain, rest), gain), divisor), avg_gain));
+                    avg_loss = V::select(seed, V::div(loss_sum, divisor),
+                                         V::select(smooth, V::div(V::add(V::mul(avg_loss, rest), loss), divisor), avg_loss));
+                    V::store(counts + j, count);
+                    V::store(avg_gains + j, avg_gain);
+                    V::store(avg_losses + j, avg_loss);
+                    result = V::select(V::ge(count, divisor), rsiFromAverages<V>(avg_gain, avg_loss), V::zero());
+                }
+                else if (t >= p)
+                {
+                    result = V::select(V::eq(bad, V::zero()),
+                                       rsiFromAverages<V>(V::div(gain_sum, divisor), V::div(loss_sum, divisor)),
+                                       V::zero());
+                }
+                V::store(out_row + j, result);
+            }
+        }
+    }
+
+    template <class V>
+    const BatchKernelTable &makeBatchKernelTable()
+    {
+        static const BatchKernelTable table = {
+            V::width,
+            &movingAverageKernel<V>,
+            &macdKernel<V>,
+            &rsiKernel<V>};
+        return table;
+    }
+}
+
+#endif
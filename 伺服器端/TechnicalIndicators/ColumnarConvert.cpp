@@ -0,0 +1,56 @@
+// 將既有的 _processed.json 轉為可 mmap 的 .kcol 欄位檔（輸出於同一資料夾），並以 ColumnarFile 讀回檢查
+// 用法: ColumnarConvert <xxx_processed.json> [...]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <filesystem>
+#include "ColumnarFile.h"
+#include "DailySeriesReader.h"
+#include "TradeSignal.h"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "用法: " << argv[0] << " <xxx_processed.json> [...]" << std::endl;
+        return 1;
+    }
+
+    // 與 KLineMain 相同的指標參數，用來判定暖機期
+    SignalConfig config;
+    config.ema_fast = 12;
+    config.ema_slow = 26;
+    config.signal_period = 9;
+    config.rsi_period = 14;
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string input = argv[i];
+        std::string output = (fs::path(input).parent_path() / (fs::path(input).stem().string() + ".kcol")).string();
+        if (!ColumnarFileWriter::convertProcessedJson(input, output, config, std::cerr))
+        {
+            ++failures;
+            continue;
+        }
+
+        ColumnarFile file;
+        if (!file.open(output, std::cerr))
+        {
+            ++failures;
+            continue;
+        }
+        ColumnView<int32_t> dates = file.dates();
+        PriceView close = file.prices(ColumnId::Close);
+        std::cout << "已生成欄位檔: " << output << " symbol=" << file.symbol() << " rows=" << file.rows();
+        if (!dates.empty())
+        {
+            std::cout << " " << formatDayNumber(dates[0]) << " ~ " << formatDayNumber(dates[dates.size() - 1])
+                      << std::fixed << std::setprecision(4) << " last_close=" << close[close.size() - 1];
+        }
+        std::cout << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
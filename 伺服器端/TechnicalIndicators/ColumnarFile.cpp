@@ -0,0 +1,728 @@
+#include "ColumnarFile.h"
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include "DailySeriesReader.h"
+#include "IndicatorState.h"
+#include "CompactCandles.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace
+{
+    const char kMagic[8] = {'K', 'C', 'O', 'L', 'U', 'M', 'N', '\0'};
+    const uint32_t kVersion = 4; // 3：有效位元圖改由指標狀態提供；4：開高低收可為 Int32 定點
+    const uint64_t kAlignment = 64;
+
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    uint64_t bitmapBytes(uint64_t rows)
+    {
+        return (rows + 63) / 64 * 8;
+    }
+
+    void writePadding(std::ofstream &out, uint64_t &position, uint64_t target)
+    {
+        static const char zeros[kAlignment] = {};
+        while (position < target)
+        {
+            uint64_t n = std::min<uint64_t>(target - position, kAlignment);
+            out.write(zeros, static_cast<std::streamsize>(n));
+            position += n;
+        }
+    }
+
+    void writeBytes(std::ofstream &out, uint64_t &position, const void *data, uint64_t size)
+    {
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        position += size;
+    }
+
+    double parseField(const json &day, const char *key)
+    {
+        auto it = day.find(key);
+        if (it == day.end() || !it->is_string())
+        {
+            throw std::runtime_error(std::string("欄位 ") + key + " 缺少或不是字串");
+        }
+        return std::strtod(it->get_ref<const std::string &>().c_str(), nullptr);
+    }
+
+    // user-017 之前的 _processed.json 沒有布林通道/ATR/OBV/VWAP 欄位，缺少時回傳 false 由呼叫端補算
+    bool optionalField(const json &day, const char *key, double &value)
+    {
+        auto it = day.find(key);
+        if (it == day.end())
+        {
+            return false;
+        }
+        value = parseField(day, key);
+        return true;
+    }
+
+    std::string stringField(const json &day, const char *key)
+    {
+        auto it = day.find(key);
+        return (it != day.end() && it->is_string()) ? it->get<std::string>() : std::string();
+    }
+}
+
+const char *columnName(ColumnId id)
+{
+    static const char *const names[] = {"date", "open", "high", "low", "close", "volume",
+                                        "ma5", "ma10", "ma20", "k", "d", "rsi",
+                                        "macd_line", "signal_line", "histogram", "price_change_percent",
+                                        "signal", "strength", "bollinger_upper", "bollinger_lower", "atr", "obv", "vwap"};
+    size_t index = static_cast<size_t>(id);
+    return index < static_cast<size_t>(ColumnId::Count) ? names[index] : "";
+}
+
+uint32_t columnValidityBit(ColumnId id)
+{
+    switch (id)
+    {
+    case ColumnId::MA5: return ValidMA5;
+    case ColumnId::MA10: return ValidMA10;
+    case ColumnId::MA20: return ValidMA20;
+    case ColumnId::K: return ValidK;
+    case ColumnId::D: return ValidD;
+    case ColumnId::RSI: return ValidRSI;
+    case ColumnId::MACDLine: return ValidMACDLine;
+    case ColumnId::SignalLine:
+    case ColumnId::Histogram: return ValidSignalLine;
+    case ColumnId::PriceChangePercent: return ValidPriceChange;
+    case ColumnId::BollingerUpper:
+    case ColumnId::BollingerLower: return ValidBollinger;
+    case ColumnId::ATR: return ValidATR;
+    case ColumnId::OBV: return ValidOBV;
+    case ColumnId::VWAP: return ValidVWAP;
+    case ColumnId::Signal:
+    case ColumnId::Strength: return ValidSignal;
+    default: return 0;
+    }
+}
+
+bool columnValid(ColumnId id, size_t row, const CandleColumns &columns, const IndicatorColumns &indicators)
+{
+    auto price = [](double value)
+    { return std::isfinite(value) && value > 0; };
+    switch (id)
+    {
+    case ColumnId::Date: return true;
+    case ColumnId::Open: return price(columns.open[row]);
+    case ColumnId::High: return price(columns.high[row]);
+    case ColumnId::Low: return price(columns.low[row]);
+    case ColumnId::Close: return price(columns.close[row]);
+    case ColumnId::Volume: return columns.volume[row] >= 0;
+    default: break;
+    }
+    if (row >= indicators.valid.size() || (indicators.valid[row] & columnValidityBit(id)) == 0)
+    {
+        return false;
+    }
+    const std::vector<double> *values = indicatorColumn(id, indicators);
+    return !values || std::isfinite((*values)[row]);
+}
+
+ColumnType columnType(ColumnId id)
+{
+    switch (id)
+    {
+    case ColumnId::Date:
+        return ColumnType::Int32;
+    case ColumnId::Volume:
+        return ColumnType::Int64;
+    case ColumnId::Signal:
+    case ColumnId::Strength:
+        return ColumnType::Int8;
+    default:
+        return ColumnType::Float64;
+    }
+}
+
+size_t columnWidth(ColumnType type)
+{
+    switch (type)
+    {
+    case ColumnType::Int8:
+        return 1;
+    case ColumnType::Int32:
+        return 4;
+    case ColumnType::Int64:
+    case ColumnType::Float64:
+        return 8;
+    }
+    return 0;
+}
+
+// ---------------- ColumnarFile ----------------
+
+ColumnarFile::~ColumnarFile()
+{
+    close();
+}
+
+ColumnarFile::ColumnarFile(ColumnarFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+ColumnarFile &ColumnarFile::operator=(ColumnarFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        base = other.base;
+        length = other.length;
+        other.base = nullptr;
+        other.length = 0;
+#ifdef _WIN32
+        file_handle = other.file_handle;
+        mapping_handle = other.mapping_handle;
+        other.file_handle = nullptr;
+        other.mapping_handle = nullptr;
+#endif
+    }
+    return *this;
+}
+
+bool ColumnarFile::open(const std::string &path, std::ostream &errors)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        errors << "無法開啟欄位檔: " << path << "\n";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        errors << "欄位檔為空或無法取得大小: " << path << "\n";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        errors << "無法映射欄位檔: " << path << "\n";
+        return false;
+    }
+    file_handle = file;
+    mapping_handle = mapping;
+    base = static_cast<const unsigned char *>(view);
+    length = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        errors << "無法開啟欄位檔: " << path << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        errors << "欄位檔為空或無法取得大小: " << path << "\n";
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // 映射建立後即可關閉檔案描述符
+    if (view == MAP_FAILED)
+    {
+        errors << "無法映射欄位檔: " << path << "\n";
+        return false;
+    }
+    base = static_cast<const unsigned char *>(view);
+    length = static_cast<size_t>(st.st_size);
+#endif
+
+    // 檢查標頭與所有區塊都在檔案範圍內
+    const ColumnarHeader *h = header();
+    auto inside = [&](uint64_t offset, uint64_t size)
+    { return offset <= length && size <= length - offset; };
+    if (length < sizeof(ColumnarHeader) || std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion)
+    {
+        errors << "欄位檔格式或版本不符: " << path << "\n";
+        close();
+        return false;
+    }
+    if (h->column_count > 1024 ||
+        !inside(h->directory_offset, static_cast<uint64_t>(h->column_count) * sizeof(ColumnarColumnEntry)) ||
+        !inside(h->meta_offset, h->meta_length) || h->row_count > length)
+    {
+        errors << "欄位檔標頭損毀: " << path << "\n";
+        close();
+        return false;
+    }
+    const ColumnarColumnEntry *entries = reinterpret_cast<const ColumnarColumnEntry *>(base + h->directory_offset);
+    for (uint32_t c = 0; c < h->column_count; ++c)
+    {
+        const ColumnarColumnEntry &entry = entries[c];
+        size_t width = entry.type <= static_cast<uint32_t>(ColumnType::Float64) ? columnWidth(static_cast<ColumnType>(entry.type)) : 0;
+        if (width == 0 || entry.values_offset % kAlignment != 0 || entry.validity_offset % kAlignment != 0 ||
+            !inside(entry.values_offset, h->row_count * width) || !inside(entry.validity_offset, bitmapBytes(h->row_count)))
+        {
+            errors << "欄位檔欄位區塊損毀: " << path << " (第 " << c << " 欄)\n";
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ColumnarFile::close()
+{
+    if (!base)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+    CloseHandle(static_cast<HANDLE>(file_handle));
+    file_handle = mapping_handle = nullptr;
+#else
+    munmap(const_cast<unsigned char *>(base), length);
+#endif
+    base = nullptr;
+    length = 0;
+}
+
+size_t ColumnarFile::rows() const
+{
+    return base ? static_cast<size_t>(header()->row_count) : 0;
+}
+
+std::string ColumnarFile::symbol() const
+{
+    if (!base)
+    {
+        return std::string();
+    }
+    const char *text = header()->symbol;
+    return std::string(text, strnlen(text, sizeof(header()->symbol)));
+}
+
+std::string ColumnarFile::metaText() const
+{
+    if (!base)
+    {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char *>(base + header()->meta_offset), header()->meta_length);
+}
+
+bool ColumnarFile::hasColumn(ColumnId id) const
+{
+    return find(id) != nullptr;
+}
+
+ColumnType ColumnarFile::storedType(ColumnId id) const
+{
+    const ColumnarColumnEntry *entry = find(id);
+    return entry ? static_cast<ColumnType>(entry->type) : columnType(id);
+}
+
+PriceView ColumnarFile::prices(ColumnId id) const
+{
+    PriceView view;
+    const ColumnarColumnEntry *entry = find(id);
+    if (!entry || (id != ColumnId::Open && id != ColumnId::High && id != ColumnId::Low && id != ColumnId::Close))
+    {
+        return view;
+    }
+    if (entry->type == static_cast<uint32_t>(ColumnType::Int32))
+    {
+        int exponent = header()->price_exponent;
+        if (exponent < 0 || exponent > CompactCandleColumns::kMaxPriceExponent)
+        {
+            return view;
+        }
+        view.fixed = reinterpret_cast<const int32_t *>(base + entry->values_offset);
+        view.scale = std::pow(10.0, exponent);
+    }
+    else if (entry->type == static_cast<uint32_t>(ColumnType::Float64))
+    {
+        view.floating = reinterpret_cast<const double *>(base + entry->values_offset);
+    }
+    else
+    {
+        return view;
+    }
+    view.validity = reinterpret_cast<const uint64_t *>(base + entry->validity_offset);
+    view.count = rows();
+    return view;
+}
+
+const ColumnarColumnEntry *ColumnarFile::find(ColumnId id) const
+{
+    if (!base)
+    {
+        return nullptr;
+    }
+    const ColumnarColumnEntry *entries = reinterpret_cast<const ColumnarColumnEntry *>(base + header()->directory_offset);
+    for (uint32_t c = 0; c < header()->column_count; ++c)
+    {
+        if (entries[c].id == static_cast<uint32_t>(id))
+        {
+            return &entries[c];
+        }
+    }
+    return nullptr;
+}
+
+// ---------------- ColumnarFileWriter ----------------
+
+bool ColumnarFileWriter::write(const std::string &path, const json &meta_data, const std::vector<int> &days,
+                               const CandleColumns &columns, const IndicatorColumns &indicators)
+{
+    static_assert(sizeof(int) == sizeof(int32_t), "date column is written directly from std::vector<int>");
+    const uint64_t rows = columns.size();
+    if (days.size() != rows || indicators.size() != rows)
+    {
+        return false;
+    }
+    const uint32_t column_count = static_cast<uint32_t>(ColumnId::Count);
+    std::string meta_text = meta_data.dump();
+
+    // 先決定所有區塊位置
+    ColumnarHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.column_count = column_count;
+    header.row_count = rows;
+    header.directory_offset = sizeof(ColumnarHeader);
+    header.meta_offset = header.directory_offset + column_count * sizeof(ColumnarColumnEntry);
+    header.meta_length = meta_text.size();
+    if (meta_data.is_object() && meta_data.contains("2. Symbol") && meta_data["2. Symbol"].is_string())
+    {
+        std::string symbol = meta_data["2. Symbol"].get<std::string>();
+        std::memcpy(header.symbol, symbol.data(), std::min(symbol.size(), sizeof(header.symbol) - 1));
+    }
+
+    // 開高低收能無損轉為定點時以 Int32 儲存，價格欄位縮小一半
+    CompactCandleColumns compact;
+    bool fixed_prices = CompactCandleColumns::encode(days, columns, compact);
+    header.price_exponent = fixed_prices ? compact.price_exponent : 0;
+    auto isPrice = [](ColumnId id)
+    { return id == ColumnId::Open || id == ColumnId::High || id == ColumnId::Low || id == ColumnId::Close; };
+
+    std::vector<ColumnarColumnEntry> entries(column_count);
+    uint64_t offset = alignUp(header.meta_offset + header.meta_length);
+    for (uint32_t c = 0; c < column_count; ++c)
+    {
+        ColumnType type = (fixed_prices && isPrice(static_cast<ColumnId>(c))) ? ColumnType::Int32 : columnType(static_cast<ColumnId>(c));
+        entries[c].id = c;
+        entries[c].type = static_cast<uint32_t>(type);
+        entries[c].values_offset = offset;
+        offset = alignUp(offset + rows * columnWidth(type));
+        entries[c].validity_offset = offset;
+        offset = alignUp(offset + bitmapBytes(rows));
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+    {
+        return false;
+    }
+    uint64_t position = 0;
+    writeBytes(out, position, &header, sizeof(header));
+    writeBytes(out, position, entries.data(), entries.size() * sizeof(ColumnarColumnEntry));
+    writeBytes(out, position, meta_text.data(), meta_text.size());
+
+    std::vector<uint64_t> bitmap(bitmapBytes(rows) / 8);
+    std::vector<double> cleaned;
+    for (uint32_t c = 0; c < column_count; ++c)
+    {
+        ColumnId id = static_cast<ColumnId>(c);
+        writePadding(out, position, entries[c].values_offset);
+        std::fill(bitmap.begin(), bitmap.end(), 0);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            if (columnValid(id, i, columns, indicators))
+            {
+                bitmap[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+
+        if (const std::vector<double> *values = indicatorColumn(id, indicators))
+        {
+            cleaned.assign(rows, 0.0);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                if ((bitmap[i / 64] >> (i % 64)) & 1u)
+                {
+                    cleaned[i] = (*values)[i];
+                }
+            }
+            writeBytes(out, position, cleaned.data(), rows * sizeof(double));
+        }
+        else
+        {
+            switch (id)
+            {
+            case ColumnId::Date:
+                writeBytes(out, position, days.data(), rows * sizeof(int32_t));
+                break;
+            case ColumnId::Open:
+                fixed_prices ? writeBytes(out, position, compact.open.data(), rows * sizeof(int32_t))
+                             : writeBytes(out, position, columns.open.data(), rows * sizeof(double));
+                break;
+            case ColumnId::High:
+                fixed_prices ? writeBytes(out, position, compact.high.data(), rows * sizeof(int32_t))
+                             : writeBytes(out, position, columns.high.data(), rows * sizeof(double));
+                break;
+            case ColumnId::Low:
+                fixed_prices ? writeBytes(out, position, compact.low.data(), rows * sizeof(int32_t))
+                             : writeBytes(out, position, columns.low.data(), rows * sizeof(double));
+                break;
+            case ColumnId::Close:
+                fixed_prices ? writeBytes(out, position, compact.close.data(), rows * sizeof(int32_t))
+                             : writeBytes(out, position, columns.close.data(), rows * sizeof(double));
+                break;
+            case ColumnId::Volume:
+                static_assert(sizeof(long long) == sizeof(int64_t), "volume column is written directly");
+                writeBytes(out, position, columns.volume.data(), rows * sizeof(int64_t));
+                break;
+            case ColumnId::Signal:
+                writeBytes(out, position, indicators.signal.data(), rows);
+                break;
+            case ColumnId::Strength:
+                writeBytes(out, position, indicators.strength.data(), rows);
+                break;
+            default:
+                break;
+            }
+        }
+
+        writePadding(out, position, entries[c].validity_offset);
+        writeBytes(out, position, bitmap.data(), bitmap.size() * sizeof(uint64_t));
+    }
+    writePadding(out, position, offset);
+    out.close();
+    return !out.fail();
+}
+
+bool ColumnarFileWriter::appendRows(const std::string &path, const json &meta_data, const std::vector<int> &days,
+                                    const CandleColumns &columns, const IndicatorColumns &tail)
+{
+    size_t rows = days.size();
+    if (tail.size() > rows)
+    {
+        return false;
+    }
+    size_t first = rows - tail.size();
+    IndicatorColumns indicators;
+    indicators.resize(rows);
+    {
+        ColumnarFile existing;
+        std::ostringstream ignored;
+        if (!existing.open(path, ignored) || existing.rows() != first)
+        {
+            return false;
+        }
+        ColumnView<int32_t> existing_days = existing.dates();
+        if (first > 0 && (existing_days.empty() || existing_days[first - 1] != days[first - 1]))
+        {
+            return false;
+        }
+        for (uint32_t c = 0; c < static_cast<uint32_t>(ColumnId::Count); ++c)
+        {
+            ColumnId id = static_cast<ColumnId>(c);
+            if (std::vector<double> *column = indicatorColumn(id, indicators))
+            {
+                ColumnView<double> view = existing.column<double>(id);
+                const std::vector<double> &tail_column = *indicatorColumn(id, tail);
+                if (view.size() != first)
+                {
+                    return false;
+                }
+                std::copy(view.begin(), view.end(), column->begin());
+                std::copy(tail_column.begin(), tail_column.end(), column->begin() + first);
+            }
+            // 既有列的有效位元取自檔案的位元圖（同一位元的欄位結果相同，重複設定無妨）
+            uint32_t bit = columnValidityBit(id);
+            if (bit != 0 && columnType(id) == ColumnType::Float64)
+            {
+                ColumnView<double> view = existing.column<double>(id);
+                for (size_t i = 0; i < first; ++i)
+                {
+                    indicators.valid[i] |= view.valid(i) ? bit : 0;
+                }
+            }
+        }
+        ColumnView<int8_t> signal = existing.column<int8_t>(ColumnId::Signal);
+        ColumnView<int8_t> strength = existing.column<int8_t>(ColumnId::Strength);
+        if (signal.size() != first || strength.size() != first)
+        {
+            return false;
+        }
+        std::copy(signal.begin(), signal.end(), indicators.signal.begin());
+        std::copy(strength.begin(), strength.end(), indicators.strength.begin());
+        std::copy(tail.signal.begin(), tail.signal.end(), indicators.signal.begin() + first);
+        std::copy(tail.strength.begin(), tail.strength.end(), indicators.strength.begin() + first);
+        for (size_t i = 0; i < first; ++i)
+        {
+            indicators.valid[i] |= signal.valid(i) ? static_cast<uint32_t>(ValidSignal) : 0u;
+        }
+        std::copy(tail.valid.begin(), tail.valid.end(), indicators.valid.begin() + first);
+    } // 寫入前先解除映射
+    return write(path, meta_data, days, columns, indicators);
+}
+
+bool ColumnarFileWriter::convertProcessedJson(const std::string &json_path, const std::string &output_path,
+                                              const SignalConfig &config, std::ostream &errors)
+{
+    std::ifstream file(json_path);
+    if (!file.is_open())
+    {
+        errors << "無法開啟檔案: " << json_path << "\n";
+        return false;
+    }
+    json j;
+    try
+    {
+        file >> j;
+    }
+    catch (const json::parse_error &e)
+    {
+        errors << "JSON 解析錯誤 (" << json_path << "): " << e.what() << "\n";
+        return false;
+    }
+    if (!j.contains("Time Series (Daily)"))
+    {
+        errors << "JSON 中缺少 'Time Series (Daily)' 鍵 (" << json_path << ")\n";
+        return false;
+    }
+
+    // json 物件的鍵依字典序排列，YYYY-MM-DD 即為日期升序
+    const json &time_series = j["Time Series (Daily)"];
+    std::vector<int> days;
+    CandleColumns columns;
+    IndicatorColumns indicators;
+    columns.reserve(time_series.size());
+    indicators.resize(time_series.size());
+    // 每列缺少的選用欄位（位元依 optional_keys 順序），於走訪指標狀態時補上
+    static const char *const optional_keys[] = {"22. bollinger_upper", "23. bollinger_lower", "24. atr", "25. obv", "26. vwap"};
+    std::vector<double> *optional_columns[] = {&indicators.bollinger_upper, &indicators.bollinger_lower,
+                                               &indicators.atr, &indicators.obv, &indicators.vwap};
+    std::vector<uint8_t> missing(time_series.size(), 0);
+    size_t row = 0;
+    for (const auto &[date, day] : time_series.items())
+    {
+        int day_number;
+        if (!parseDayNumber(date.data(), date.size(), day_number))
+        {
+            errors << "無法轉換數據 for " << date << " (" << json_path << "): 日期格式錯誤\n";
+            continue;
+        }
+        try
+        {
+            columns.open.push_back(parseField(day, "1. open"));
+            columns.high.push_back(parseField(day, "2. high"));
+            columns.low.push_back(parseField(day, "3. low"));
+            columns.close.push_back(parseField(day, "4. close"));
+            columns.volume.push_back(static_cast<long long>(parseField(day, "5. volume")));
+            indicators.ma5[row] = parseField(day, "6. ma5");
+            indicators.ma10[row] = parseField(day, "7. ma10");
+            indicators.ma20[row] = parseField(day, "8. ma20");
+            indicators.k[row] = parseField(day, "9. k");
+            indicators.d[row] = parseField(day, "10. d");
+            indicators.rsi[row] = parseField(day, "11. rsi");
+            indicators.macd_line[row] = parseField(day, "12. macd_line");
+            indicators.signal_line[row] = parseField(day, "13. signal_line");
+            indicators.histogram[row] = parseField(day, "14. histogram");
+            indicators.price_change_percent[row] = parseField(day, "15. price_change_percent");
+            for (size_t f = 0; f < 5; ++f)
+            {
+                if (!optionalField(day, optional_keys[f], (*optional_columns[f])[row]))
+                {
+                    missing[row] |= static_cast<uint8_t>(1u << f);
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            errors << "無法轉換數據 for " << date << " (" << json_path << "): " << e.what() << "\n";
+            // 捨棄這一筆已加入的 K 線欄位
+            missing[row] = 0;
+            size_t n = days.size();
+            columns.open.resize(n);
+            columns.high.resize(n);
+            columns.low.resize(n);
+            columns.close.resize(n);
+            columns.volume.resize(n);
+            continue;
+        }
+        std::string signal = stringField(day, "16. signal"), strength = stringField(day, "17. strength");
+        indicators.signal[row] = signal == signalText(1) ? 1 : (signal == signalText(-1) ? -1 : 0);
+        indicators.strength[row] = strength == strengthText(2) ? 2 : (strength == strengthText(1) ? 1 : 0);
+        days.push_back(day_number);
+        ++row;
+    }
+    // 略過的資料列不佔指標欄位
+    for (auto *column : {&indicators.ma5, &indicators.ma10, &indicators.ma20, &indicators.k, &indicators.d, &indicators.rsi,
+                         &indicators.macd_line, &indicators.signal_line, &indicators.histogram, &indicators.price_change_percent,
+                         &indicators.bollinger_upper, &indicators.bollinger_lower, &indicators.atr, &indicators.obv, &indicators.vwap})
+    {
+        column->resize(row);
+    }
+    indicators.signal.resize(row);
+    indicators.strength.resize(row);
+
+    // 值沿用 JSON，有效位元由指標狀態重新走訪一次取得（與 KLineMain 相同的 lookback）
+    IndicatorState state(config, config.ema_slow + config.signal_period - 1);
+    indicators.valid.resize(row);
+    for (size_t i = 0; i < row; ++i)
+    {
+        IndicatorRow computed = state.advance(columns.high[i], columns.low[i], columns.close[i], columns.volume[i]);
+        indicators.valid[i] = computed.valid;
+        if (missing[i] != 0)
+        {
+            const double values[] = {computed.bollinger_upper, computed.bollinger_lower, computed.atr, computed.obv, computed.vwap};
+            for (size_t f = 0; f < 5; ++f)
+            {
+                if (missing[i] & (1u << f))
+                {
+                    (*optional_columns[f])[i] = values[f];
+                }
+            }
+        }
+    }
+    if (row == 0)
+    {
+        errors << "沒有可轉換的資料列 (" << json_path << ")\n";
+        return false;
+    }
+
+    json meta_data = j.contains("Meta Data") ? j["Meta Data"] : json::object();
+    if (!write(output_path, meta_data, days, columns, indicators))
+    {
+        errors << "無法創建輸出檔案: " << output_path << "\n";
+        return false;
+    }
+    return true;
+}
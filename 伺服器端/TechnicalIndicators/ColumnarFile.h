@@ -0,0 +1,233 @@
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "IndicatorPipeline.h"
+#include "TradeSignal.h"
+#include "json.hpp"
+
+// 單一股票的二進位欄位檔（.kcol），可直接 mmap 使用而不需解析。
+// 檔案配置（little-endian，所有區塊對齊 64 位元組）：
+//   ColumnarHeader | ColumnarColumnEntry[column_count] | Meta Data JSON 文字 |
+//   每個欄位：固定寬度的值區塊 + 有效位元圖（第 i 筆有效時 bit i 為 1）
+// 無效（指標暖機期、輸入無效或非有限值）的數值存為 0，與 _processed.json 相同；有效與否以位元圖區分。
+// 開高低收能無損表示時以 CompactCandleColumns 的 32 位元定點整數儲存（價格 = 整數 / 10^price_exponent），
+// 否則為 Float64；讀取價格一律經由 ColumnarFile::prices
+
+enum class ColumnId : uint32_t
+{
+    Date, // int32，1970-01-01 起算的日序
+    Open,
+    High,
+    Low,
+    Close,
+    Volume, // int64
+    MA5,
+    MA10,
+    MA20,
+    K,
+    D,
+    RSI,
+    MACDLine,
+    SignalLine,
+    Histogram,
+    PriceChangePercent,
+    Signal,   // int8，1 買進 / -1 賣出 / 0 無
+    Strength, // int8，2 強 / 1 中 / 0 無
+    BollingerUpper,
+    BollingerLower,
+    ATR,
+    OBV,
+    VWAP,
+    Count
+};
+
+enum class ColumnType : uint32_t
+{
+    Int8,
+    Int32,
+    Int64,
+    Float64
+};
+
+const char *columnName(ColumnId id);
+// 欄位的預設型別；開高低收以定點儲存時實際型別為 Int32，見 ColumnarFile::storedType
+ColumnType columnType(ColumnId id);
+size_t columnWidth(ColumnType type);
+
+// 欄位對應的 IndicatorValidity 位元，日期與 K 線欄位回傳 0
+uint32_t columnValidityBit(ColumnId id);
+// 第 row 列的欄位是否有效：指標與訊號依 IndicatorColumns::valid 且須為有限值，
+// K 線價格須為正的有限值、成交量不得為負，日期恆為有效
+bool columnValid(ColumnId id, size_t row, const CandleColumns &columns, const IndicatorColumns &indicators);
+
+// ColumnId 對應的 double 指標欄位，Columns 為 IndicatorColumns 或 const IndicatorColumns；
+// K 線、日期與訊號欄位回傳 nullptr
+template <class Columns>
+inline auto indicatorColumn(ColumnId id, Columns &indicators) -> decltype(&indicators.ma5)
+{
+    switch (id)
+    {
+    case ColumnId::MA5: return &indicators.ma5;
+    case ColumnId::MA10: return &indicators.ma10;
+    case ColumnId::MA20: return &indicators.ma20;
+    case ColumnId::K: return &indicators.k;
+    case ColumnId::D: return &indicators.d;
+    case ColumnId::RSI: return &indicators.rsi;
+    case ColumnId::MACDLine: return &indicators.macd_line;
+    case ColumnId::SignalLine: return &indicators.signal_line;
+    case ColumnId::Histogram: return &indicators.histogram;
+    case ColumnId::PriceChangePercent: return &indicators.price_change_percent;
+    case ColumnId::BollingerUpper: return &indicators.bollinger_upper;
+    case ColumnId::BollingerLower: return &indicators.bollinger_lower;
+    case ColumnId::ATR: return &indicators.atr;
+    case ColumnId::OBV: return &indicators.obv;
+    case ColumnId::VWAP: return &indicators.vwap;
+    default: return nullptr;
+    }
+}
+
+#pragma pack(push, 1)
+struct ColumnarHeader
+{
+    char magic[8]; // "KCOLUMN\0"
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t row_count;
+    uint64_t directory_offset;
+    uint64_t meta_offset;
+    uint64_t meta_length;
+    char symbol[32]; // 以 '\0' 結尾
+    int32_t price_exponent; // 開高低收為 Int32 定點時的小數位數
+    uint8_t reserved[44];
+};
+
+struct ColumnarColumnEntry
+{
+    uint32_t id;
+    uint32_t type;
+    uint64_t values_offset;
+    uint64_t validity_offset;
+    uint64_t reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ColumnarHeader) == 128, "ColumnarHeader must stay 128 bytes");
+static_assert(sizeof(ColumnarColumnEntry) == 32, "ColumnarColumnEntry must stay 32 bytes");
+
+// 指向映射記憶體的唯讀欄位，不複製資料；檔案關閉後失效
+template <class T>
+struct ColumnView
+{
+    const T *data = nullptr;
+    const uint64_t *validity = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T operator[](size_t i) const { return data[i]; }
+    bool valid(size_t i) const { return (validity[i / 64] >> (i % 64)) & 1u; }
+    const T *begin() const { return data; }
+    const T *end() const { return data + count; }
+};
+
+// 開高低收的唯讀欄位：定點或 Float64 儲存皆以 double 價格讀取，定點值以除法還原，與原始 double 逐位元相同
+struct PriceView
+{
+    const int32_t *fixed = nullptr;
+    const double *floating = nullptr;
+    const uint64_t *validity = nullptr;
+    double scale = 1.0;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    double operator[](size_t i) const { return fixed ? fixed[i] / scale : floating[i]; }
+    bool valid(size_t i) const { return (validity[i / 64] >> (i % 64)) & 1u; }
+};
+
+// 以 mmap（Windows 為 MapViewOfFile）開啟 .kcol 檔，開啟時只檢查標頭與區塊範圍
+class ColumnarFile
+{
+public:
+    ColumnarFile() = default;
+    ~ColumnarFile();
+    ColumnarFile(const ColumnarFile &) = delete;
+    ColumnarFile &operator=(const ColumnarFile &) = delete;
+    ColumnarFile(ColumnarFile &&other) noexcept;
+    ColumnarFile &operator=(ColumnarFile &&other) noexcept;
+
+    // 檔案不存在或格式不符時回傳 false，錯誤原因寫入 errors
+    bool open(const std::string &path, std::ostream &errors);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    size_t rows() const;
+    std::string symbol() const;
+    std::string metaText() const; // Meta Data 的 JSON 文字
+    bool hasColumn(ColumnId id) const;
+    // 檔案中該欄位實際的型別，欄位不存在時為 columnType(id)
+    ColumnType storedType(ColumnId id) const;
+
+    // T 必須與欄位型別相符（int8_t/int32_t/int64_t/double），否則回傳空的 view
+    template <class T>
+    ColumnView<T> column(ColumnId id) const
+    {
+        ColumnView<T> view;
+        const ColumnarColumnEntry *entry = find(id);
+        if (entry && columnWidth(static_cast<ColumnType>(entry->type)) == sizeof(T) && matchesType<T>(entry->type))
+        {
+            view.data = reinterpret_cast<const T *>(base + entry->values_offset);
+            view.validity = reinterpret_cast<const uint64_t *>(base + entry->validity_offset);
+            view.count = rows();
+        }
+        return view;
+    }
+
+    ColumnView<int32_t> dates() const { return column<int32_t>(ColumnId::Date); }
+    // id 須為 Open/High/Low/Close，其他欄位回傳空的 view
+    PriceView prices(ColumnId id) const;
+
+private:
+    template <class T>
+    static bool matchesType(uint32_t type);
+    const ColumnarColumnEntry *find(ColumnId id) const;
+    const ColumnarHeader *header() const { return reinterpret_cast<const ColumnarHeader *>(base); }
+
+    const unsigned char *base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#endif
+};
+
+template <>
+inline bool ColumnarFile::matchesType<int8_t>(uint32_t type) { return type == static_cast<uint32_t>(ColumnType::Int8); }
+template <>
+inline bool ColumnarFile::matchesType<int32_t>(uint32_t type) { return type == static_cast<uint32_t>(ColumnType::Int32); }
+template <>
+inline bool ColumnarFile::matchesType<int64_t>(uint32_t type) { return type == static_cast<uint32_t>(ColumnType::Int64); }
+template <>
+inline bool ColumnarFile::matchesType<double>(uint32_t type) { return type == static_cast<uint32_t>(ColumnType::Float64); }
+
+// 寫出 .kcol 檔；有效位元圖依 columnValid 判定，開高低收能以定點無損表示時存為 Int32
+class ColumnarFileWriter
+{
+public:
+    static bool write(const std::string &path, const nlohmann::json &meta_data, const std::vector<int> &days,
+                      const CandleColumns &columns, const IndicatorColumns &indicators);
+    // 以 path 既有檔案的指標值與有效位元加上 tail（對應 days/columns 的最後 tail.size() 筆）重寫整個檔案；
+    // 欄位區塊無法原地延長。既有檔案的列數或最後日期不符時回傳 false
+    static bool appendRows(const std::string &path, const nlohmann::json &meta_data, const std::vector<int> &days,
+                           const CandleColumns &columns, const IndicatorColumns &tail);
+    // 將既有的 _processed.json 轉為 .kcol；JSON 不記錄有效與否，以 config 重新走訪 K 線取得各列的有效位元，
+    // 舊格式缺少的布林通道/ATR/OBV/VWAP 欄位同時由這次走訪補算。沒有任何資料列可轉換時回傳 false
+    static bool convertProcessedJson(const std::string &json_path, const std::string &output_path,
+                                     const SignalConfig &config, std::ostream &errors);
+};
+
+#endif
@@ -0,0 +1,142 @@
+// 緊湊 K 線欄位的記憶體與正確性比較：vector<Candle>、vector<KLineRecord>、CandleColumns 與 CompactCandleColumns
+// 用法：CompactCandleBenchmark [股票數=200] [天數=5000] [推估總 K 線數=25000000]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "KLine.h"
+#include "KLineRecord.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "CompactCandles.h"
+#include "SyntheticCandles.h"
+
+namespace
+{
+    // 幾何布朗運動產生的模擬 K 線，價格取 4 位小數（與 API 資料相同）
+    void generateSymbol(SyntheticCandles &generator, size_t steps, double start, std::vector<int> &days, CandleColumns &columns)
+    {
+        auto round4 = [](double price)
+        { return std::round(price * 10000.0) / 10000.0; };
+        generator.reset(start);
+        days.resize(steps);
+        columns = CandleColumns();
+        columns.reserve(steps);
+        for (size_t t = 0; t < steps; ++t)
+        {
+            SyntheticCandle c = generator.next();
+            long long volume = static_cast<long long>(1e6 + 4e9 * generator.uniform()); // 部分超過 32 位元上限
+            days[t] = 10000 + static_cast<int>(t);
+            columns.push_back(Candle(round4(c.open), round4(c.high), round4(c.low), round4(c.close), volume));
+        }
+    }
+
+    bool sameBits(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    bool sameIndicators(const IndicatorColumns &a, const IndicatorColumns &b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (!sameBits(a.ma20[i], b.ma20[i]) || !sameBits(a.k[i], b.k[i]) || !sameBits(a.rsi[i], b.rsi[i]) ||
+                !sameBits(a.histogram[i], b.histogram[i]) || a.signal[i] != b.signal[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void report(const std::string &layout, double bytes_per_bar, size_t bars, size_t projected)
+    {
+        std::cout << std::left << std::setw(28) << layout << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << bytes_per_bar << " B/bar"
+                  << std::setw(12) << bytes_per_bar * bars / (1024.0 * 1024.0) << " MiB"
+                  << std::setw(10) << std::setprecision(2) << bytes_per_bar * projected / (1024.0 * 1024.0 * 1024.0)
+                  << " GiB @" << projected << " bars\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t symbols = (argc > 1) ? std::stoul(argv[1]) : 200;
+    size_t steps = (argc > 2) ? std::stoul(argv[2]) : 5000;
+    size_t projected = (argc > 3) ? std::stoul(argv[3]) : 25000000;
+    size_t bars = symbols * steps;
+
+    SyntheticCandles generator(20240601);
+    SignalConfig config;
+    int lookback = config.ema_slow + config.signal_period - 1;
+    IndicatorPipeline pipeline(config);
+
+    size_t compact_bytes = 0, column_bytes = 0, lossy = 0, indicator_mismatch = 0, failed = 0;
+    double column_ms = 0.0, compact_ms = 0.0;
+    std::vector<int> exponents(CompactCandleColumns::kMaxPriceExponent + 1, 0);
+    for (size_t s = 0; s < symbols; ++s)
+    {
+        std::vector<int> days;
+        CandleColumns columns;
+        generateSymbol(generator, steps, 5.0 + 10.0 * (s % 50), days, columns);
+
+        CompactCandleColumns compact;
+        if (!CompactCandleColumns::encode(days, columns, compact))
+        {
+            ++failed;
+            continue;
+        }
+        ++exponents[compact.price_exponent];
+        compact_bytes += compact.memoryBytes();
+        column_bytes += steps * (4 * sizeof(double) + sizeof(long long) + sizeof(int));
+
+        // 與 Candle 互轉必須無損
+        for (size_t i = 0; i < steps; ++i)
+        {
+            Candle c = compact.candle(i);
+            if (!sameBits(c.getOpen(), columns.open[i]) || !sameBits(c.getHigh(), columns.high[i]) ||
+                !sameBits(c.getLow(), columns.low[i]) || !sameBits(c.getClose(), columns.close[i]) ||
+                c.getVolume() != columns.volume[i] || compact.day[i] != days[i])
+            {
+                ++lossy;
+                break;
+            }
+        }
+
+        // 指標管線直接讀取緊湊欄位，結果必須與 double 欄位相同
+        IndicatorColumns expected, actual;
+        IndicatorState expected_state(config, lookback), actual_state(config, lookback);
+        column_ms += elapsedMs([&]
+                               { pipeline.run(columns, expected, expected_state); });
+        compact_ms += elapsedMs([&]
+                                { pipeline.run(compact, actual, actual_state); });
+        if (!sameIndicators(expected, actual))
+        {
+            ++indicator_mismatch;
+        }
+    }
+
+    size_t encoded = bars - failed * steps;
+    std::cout << "symbols=" << symbols << " steps=" << steps << " encode_failed=" << failed
+              << " lossy=" << lossy << " indicator_mismatch=" << indicator_mismatch << " price_exponents:";
+    for (size_t e = 0; e < exponents.size(); ++e)
+    {
+        if (exponents[e])
+        {
+            std::cout << " 10^-" << e << "x" << exponents[e];
+        }
+    }
+    std::cout << "\n";
+
+    // KLineRecord 的日期與訊號字串皆在 SSO 範圍內，不另配置堆積記憶體
+    report("vector<KLineRecord>", sizeof(KLineRecord), bars, projected);
+    report("vector<Candle> + date str", sizeof(Candle) + sizeof(std::string), bars, projected);
+    report("CandleColumns + day", encoded ? static_cast<double>(column_bytes) / encoded : 0.0, bars, projected);
+    report("CompactCandleColumns", encoded ? static_cast<double>(compact_bytes) / encoded : 0.0, bars, projected);
+    std::cout << std::fixed << std::setprecision(2) << "pipeline CandleColumns " << column_ms << " ms, CompactCandleColumns "
+              << compact_ms << " ms\n";
+    return (lossy == 0 && indicator_mismatch == 0) ? 0 : 1;
+}
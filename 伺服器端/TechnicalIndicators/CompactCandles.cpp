@@ -0,0 +1,115 @@
+#include "CompactCandles.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double kPowersOfTen[CompactCandleColumns::kMaxPriceExponent + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+    // price 能以 10^-exponent 為單位的 32 位元整數精確還原時寫入 value
+    bool toFixed(double price, int exponent, int32_t &value)
+    {
+        double scale = kPowersOfTen[exponent];
+        double scaled = std::nearbyint(price * scale);
+        if (!(std::fabs(scaled) <= std::numeric_limits<int32_t>::max()))
+        {
+            return false;
+        }
+        value = static_cast<int32_t>(scaled);
+        return value / scale == price;
+    }
+
+    // 找出能表示 price 的最小小數位數（不小於 exponent），無法表示時回傳 -1
+    int requiredExponent(double price, int exponent)
+    {
+        int32_t value;
+        for (; exponent <= CompactCandleColumns::kMaxPriceExponent; ++exponent)
+        {
+            if (toFixed(price, exponent, value))
+            {
+                return exponent;
+            }
+        }
+        return -1;
+    }
+}
+
+size_t CompactCandleColumns::memoryBytes() const
+{
+    return (day.capacity() + open.capacity() + high.capacity() + low.capacity() + close.capacity()) * sizeof(int32_t) +
+           volume.capacity() * sizeof(int64_t);
+}
+
+Candle CompactCandleColumns::candle(size_t i) const
+{
+    return Candle(price(open[i]), price(high[i]), price(low[i]), price(close[i]), volume[i]);
+}
+
+CandleColumns CompactCandleColumns::toCandleColumns() const
+{
+    CandleColumns columns;
+    size_t n = size();
+    columns.open.resize(n);
+    columns.high.resize(n);
+    columns.low.resize(n);
+    columns.close.resize(n);
+    columns.volume.assign(volume.begin(), volume.end());
+    for (size_t i = 0; i < n; ++i)
+    {
+        columns.open[i] = price(open[i]);
+        columns.high[i] = price(high[i]);
+        columns.low[i] = price(low[i]);
+        columns.close[i] = price(close[i]);
+    }
+    return columns;
+}
+
+bool CompactCandleColumns::encode(const std::vector<int> &days, const CandleColumns &columns, CompactCandleColumns &out)
+{
+    size_t n = columns.size();
+    if (days.size() != n)
+    {
+        return false;
+    }
+
+    // 第一次走訪決定小數位數，第二次才轉換，避免位數提高時重算已轉換的值
+    int exponent = 0;
+    for (const std::vector<double> *column : {&columns.open, &columns.high, &columns.low, &columns.close})
+    {
+        for (double price : *column)
+        {
+            exponent = requiredExponent(price, exponent);
+            if (exponent < 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    CompactCandleColumns result;
+    result.price_exponent = exponent;
+    result.price_scale = kPowersOfTen[exponent];
+    result.day.assign(days.begin(), days.end());
+    result.volume.assign(columns.volume.begin(), columns.volume.end());
+    const std::vector<double> *sources[4] = {&columns.open, &columns.high, &columns.low, &columns.close};
+    std::vector<int32_t> *targets[4] = {&result.open, &result.high, &result.low, &result.close};
+    for (int c = 0; c < 4; ++c)
+    {
+        targets[c]->resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            // 較小位數可表示的價格在較大位數下也可精確表示（同一有理數的正確捨入）
+            if (!toFixed((*sources[c])[i], exponent, (*targets[c])[i]))
+            {
+                return false;
+            }
+        }
+    }
+    out = std::move(result);
+    return true;
+}
+
+bool CompactCandleColumns::fromCandles(const std::vector<int> &days, const std::vector<Candle> &candles, CompactCandleColumns &out)
+{
+    return encode(days, CandleColumns::fromCandles(candles), out);
+}
@@ -0,0 +1,35 @@
+#ifndef COMPACT_CANDLES_H
+#define COMPACT_CANDLES_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "KLine.h"
+#include "IndicatorPipeline.h"
+
+// 單一股票的緊湊 K 線欄位：價格為 32 位元定點整數（實際價格 = 整數 / 10^price_exponent，
+// 每檔股票各自選擇能無損表示所有價格的最小小數位數），成交量 64 位元，日期為 32 位元日序。
+// 每根 K 線 28 位元組，Candle 為 48 位元組、CandleColumns 為 40 位元組（不含日期）
+struct CompactCandleColumns
+{
+    static const int kMaxPriceExponent = 8;
+
+    int price_exponent = 0;
+    double price_scale = 1.0; // 10^price_exponent
+    std::vector<int32_t> day;
+    std::vector<int32_t> open, high, low, close;
+    std::vector<int64_t> volume;
+
+    size_t size() const { return close.size(); }
+    size_t memoryBytes() const;
+
+    // 以除法還原，結果與原本的 double 逐位元相同
+    double price(int32_t value) const { return value / price_scale; }
+    Candle candle(size_t i) const;
+    CandleColumns toCandleColumns() const;
+
+    // 所有價格都能以 32 位元定點無損表示時回傳 true；price_change_percent 由指標管線重新計算，不保存
+    static bool encode(const std::vector<int> &days, const CandleColumns &columns, CompactCandleColumns &out);
+    static bool fromCandles(const std::vector<int> &days, const std::vector<Candle> &candles, CompactCandleColumns &out);
+};
+
+#endif
@@ -0,0 +1,219 @@
+// 相關係數矩陣的效能測試：分塊 SIMD 核心與逐對計算的直觀寫法比對，
+// 並驗證單日增量更新（含同一物件重複 compute 之後）與重新計算整個視窗的結果一致
+// 用法：CorrelationBenchmark [股票數=2000] [視窗天數=250] [執行緒數=0]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include "CorrelationMatrix.h"
+#include "ParallelBatch.h"
+#include "SyntheticCandles.h"
+
+namespace
+{
+    struct Prices
+    {
+        std::vector<int> days;
+        std::vector<double> close;
+    };
+
+    // 以共同市場因子驅動的幾何布朗運動，讓股票之間有非零相關；每檔隨機缺少少數交易日
+    std::vector<Prices> generatePrices(size_t symbols, size_t steps)
+    {
+        SyntheticCandles generator(20240615, 0.015);
+        std::vector<double> market(steps);
+        for (double &m : market)
+        {
+            m = generator.gaussian();
+        }
+        std::vector<Prices> result(symbols);
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            double beta = 0.2 + 0.8 * generator.uniform();
+            generator.reset(SyntheticCandles::startPrice(s));
+            for (size_t t = 0; t < steps; ++t)
+            {
+                double price = generator.nextClose(0.01 * beta * market[t]);
+                if (t == 0 || generator.uniform() > 0.002)
+                {
+                    result[s].days.push_back(19000 + static_cast<int>(t));
+                    result[s].close.push_back(price);
+                }
+            }
+        }
+        return result;
+    }
+
+    // 直觀寫法：每一對股票各自以兩趟平均與離差計算相關係數
+    double naiveCorrelation(const std::vector<double> &x, const std::vector<double> &y)
+    {
+        double mx = 0.0, my = 0.0;
+        for (size_t t = 0; t < x.size(); ++t)
+        {
+            mx += x[t];
+            my += y[t];
+        }
+        mx /= x.size();
+        my /= y.size();
+        double sxy = 0.0, sxx = 0.0, syy = 0.0;
+        for (size_t t = 0; t < x.size(); ++t)
+        {
+            sxy += (x[t] - mx) * (y[t] - my);
+            sxx += (x[t] - mx) * (x[t] - mx);
+            syy += (y[t] - my) * (y[t] - my);
+        }
+        return sxy / std::sqrt(sxx * syy);
+    }
+
+    // 對齊到 days 之後的對數報酬（缺價日沿用前一收盤價）；任何一天缺報酬時回傳空序列
+    std::vector<double> alignedReturns(const Prices &prices, const std::vector<int> &days)
+    {
+        std::vector<double> result;
+        double prev = std::nan(""), price = std::nan("");
+        size_t k = 0;
+        for (size_t t = 0; t < days.size(); ++t)
+        {
+            while (k < prices.days.size() && prices.days[k] <= days[t])
+            {
+                price = prices.close[k++];
+            }
+            if (t > 0)
+            {
+                if (std::isnan(prev) || std::isnan(price))
+                {
+                    return std::vector<double>();
+                }
+                result.push_back(std::log(price / prev));
+            }
+            prev = price;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t symbols = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t window = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 250;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    const size_t extra_days = 5;
+
+    // 多產生 extra_days 天，前段用來計算、後段逐日以 addDay 加入
+    std::vector<Prices> full = generatePrices(symbols, window + 1 + extra_days);
+    std::vector<Prices> initial(symbols);
+    std::vector<CloseSeries> series(symbols);
+    int last_initial_day = 19000 + static_cast<int>(window);
+    for (size_t s = 0; s < symbols; ++s)
+    {
+        for (size_t k = 0; k < full[s].days.size() && full[s].days[k] <= last_initial_day; ++k)
+        {
+            initial[s].days.push_back(full[s].days[k]);
+            initial[s].close.push_back(full[s].close[k]);
+        }
+        series[s] = CloseSeries{"S" + std::to_string(s), &initial[s].days, &initial[s].close};
+    }
+
+    ParallelBatch batch(threads);
+    CorrelationMatrix matrix(window);
+    double compute_s = elapsedMs([&]
+                                 { matrix.compute(series, batch); }) / 1000.0;
+
+    // 抽樣前 200 檔與直觀寫法逐對比對
+    size_t checked = std::min<size_t>(symbols, 200), mismatches = 0, usable = 0;
+    std::vector<int> calendar = matrix.windowDays();
+    calendar.insert(calendar.begin(), calendar.front() - 1);
+    std::vector<std::vector<double>> returns(checked);
+    for (size_t i = 0; i < checked; ++i)
+    {
+        returns[i] = alignedReturns(initial[i], calendar);
+        usable += matrix.usable(i);
+        mismatches += returns[i].empty() == matrix.usable(i);
+    }
+    double naive_ms = elapsedMs([&]
+                                {
+        for (size_t i = 0; i < checked; ++i)
+        {
+            for (size_t j = 0; j < checked; ++j)
+            {
+                if (!returns[i].empty() && !returns[j].empty())
+                {
+                    mismatches += std::fabs(matrix.correlation(i, j) - naiveCorrelation(returns[i], returns[j])) > 1e-9;
+                }
+            }
+        } });
+    double naive_pair_s = naive_ms / 1000.0 / (checked * checked);
+
+    // 同一物件重複 compute：先以較短的歷史計算，再以完整的初始資料重算，之後的增量更新須與全新物件一致
+    std::vector<Prices> shorter(symbols);
+    std::vector<CloseSeries> shorter_series(symbols);
+    for (size_t s = 0; s < symbols; ++s)
+    {
+        for (size_t k = 0; k < initial[s].days.size() && initial[s].days[k] <= 19000 + static_cast<int>(window * 3 / 5); ++k)
+        {
+            shorter[s].days.push_back(initial[s].days[k]);
+            shorter[s].close.push_back(initial[s].close[k]);
+        }
+        shorter_series[s] = CloseSeries{series[s].symbol, &shorter[s].days, &shorter[s].close};
+    }
+    CorrelationMatrix reused(window);
+    reused.compute(shorter_series, batch);
+    reused.compute(series, batch);
+
+    // 逐日增量更新，最後與以完整資料重新計算的結果比對
+    double update_s = 0.0;
+    for (size_t d = 1; d <= extra_days; ++d)
+    {
+        int day = last_initial_day + static_cast<int>(d);
+        std::vector<double> closes(symbols, std::nan(""));
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            for (size_t k = 0; k < full[s].days.size(); ++k)
+            {
+                if (full[s].days[k] == day)
+                {
+                    closes[s] = full[s].close[k];
+                }
+            }
+        }
+        update_s += elapsedMs([&]
+                              { mismatches += !matrix.addDay(day, closes, batch); }) / 1000.0;
+        mismatches += !reused.addDay(day, closes, batch);
+    }
+    for (size_t s = 0; s < symbols; ++s)
+    {
+        series[s].days = &full[s].days;
+        series[s].close = &full[s].close;
+    }
+    CorrelationMatrix fresh(window);
+    fresh.compute(series, batch);
+    double max_update_error = 0.0, max_reuse_error = 0.0;
+    for (size_t i = 0; i < symbols; ++i)
+    {
+        mismatches += matrix.usable(i) != fresh.usable(i);
+        mismatches += reused.usable(i) != fresh.usable(i);
+        for (size_t j = 0; j < symbols && matrix.usable(i); ++j)
+        {
+            if (matrix.usable(j))
+            {
+                max_update_error = std::max(max_update_error, std::fabs(matrix.correlation(i, j) - fresh.correlation(i, j)));
+                max_reuse_error = std::max(max_reuse_error, std::fabs(reused.correlation(i, j) - fresh.correlation(i, j)));
+            }
+        }
+    }
+    mismatches += max_update_error > 1e-9;
+    mismatches += max_reuse_error > 1e-9;
+
+    double flops = 2.0 * symbols * symbols / 2.0 * window;
+    std::cout << std::fixed << std::setprecision(3)
+              << "股票數 " << symbols << "，視窗 " << window << " 天，核心 " << CorrelationMatrix::kernelName()
+              << "，" << batch.getThreadCount() << " 執行緒，可用股票 " << usable << "/" << checked << "（抽樣）\n"
+              << "完整計算:   " << compute_s << " s, " << flops / compute_s / 1e9 << " GFLOP/s\n"
+              << "直觀寫法估計: " << naive_pair_s * symbols * symbols << " s（抽樣 " << checked << " 檔逐對外推）\n"
+              << "單日增量:   " << update_s / extra_days * 1000.0 << " ms/天\n"
+              << std::scientific << std::setprecision(2) << "增量與重新計算最大差異 " << max_update_error << "\n"
+              << "重複計算後增量與重新計算最大差異 " << max_reuse_error << "\n"
+              << (mismatches == 0 ? "結果一致" : "結果不一致: " + std::to_string(mismatches)) << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#ifndef CORRELATION_KERNELS_H
+#define CORRELATION_KERNELS_H
+#include <cstddef>
+
+// 相關係數矩陣的交叉乘積核心，僅供 CorrelationMatrix.cpp 與 CorrelationMatrixAVX2.cpp 內部使用。
+// 報酬依 8 檔一組打包成面板，面板內 time-major 存放（panel[t * 8 + k]），
+// 核心計算兩個面板的 8x8 交叉乘積區塊：out[r * 8 + c] = Σ_t a[t * 8 + r] * b[t * 8 + c]
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CORRELATION_X86_KERNELS 1
+#endif
+
+const size_t kCorrelationPanelWidth = 8;
+
+typedef void (*CrossProductTile)(const double *a, const double *b, size_t steps, double *out);
+
+CrossProductTile scalarCrossProductTile();
+#ifdef CORRELATION_X86_KERNELS
+CrossProductTile sse2CrossProductTile();
+CrossProductTile avx2CrossProductTile();
+#endif
+
+namespace
+{
+    // 一次處理 4 列 x 8 欄，累加器常駐暫存器；兩半各走一次時間軸
+    template <class V>
+    void crossProductTile(const double *a, const double *b, size_t steps, double *out)
+    {
+        const size_t lanes = kCorrelationPanelWidth / V::width;
+        for (size_t half = 0; half < 2; ++half)
+        {
+            typename V::vec acc[4][lanes];
+            for (size_t r = 0; r < 4; ++r)
+            {
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    acc[r][l] = V::zero();
+                }
+            }
+            for (size_t t = 0; t < steps; ++t)
+            {
+                const double *x = a + t * kCorrelationPanelWidth + half * 4;
+                const double *y = b + t * kCorrelationPanelWidth;
+                typename V::vec column[lanes];
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    column[l] = V::load(y + l * V::width);
+                }
+                for (size_t r = 0; r < 4; ++r)
+                {
+                    typename V::vec row = V::set1(x[r]);
+                    for (size_t l = 0; l < lanes; ++l)
+                    {
+                        acc[r][l] = V::madd(row, column[l], acc[r][l]);
+                    }
+                }
+            }
+            for (size_t r = 0; r < 4; ++r)
+            {
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    V::store(out + (half * 4 + r) * kCorrelationPanelWidth + l * V::width, acc[r][l]);
+                }
+            }
+        }
+    }
+}
+
+#endif
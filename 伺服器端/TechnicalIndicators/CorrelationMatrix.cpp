@@ -0,0 +1,344 @@
+#include "CorrelationMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "CorrelationKernels.h"
+#include "ParallelBatch.h"
+
+#ifdef CORRELATION_X86_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct ScalarOps
+    {
+        typedef double vec;
+        static const size_t width = 1;
+
+        static vec zero() { return 0.0; }
+        static vec set1(double v) { return v; }
+        static vec load(const double *p) { return *p; }
+        static void store(double *p, vec v) { *p = v; }
+        static vec madd(vec a, vec b, vec c) { return a * b + c; }
+    };
+
+#ifdef CORRELATION_X86_KERNELS
+    struct SSE2Ops
+    {
+        typedef __m128d vec;
+        static const size_t width = 2;
+
+        static vec zero() { return _mm_setzero_pd(); }
+        static vec set1(double v) { return _mm_set1_pd(v); }
+        static vec load(const double *p) { return _mm_loadu_pd(p); }
+        static void store(double *p, vec v) { _mm_storeu_pd(p, v); }
+        static vec madd(vec a, vec b, vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    };
+#endif
+
+    CrossProductTile bestTile()
+    {
+#ifdef CORRELATION_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return avx2CrossProductTile();
+        }
+        return sse2CrossProductTile();
+#else
+        return scalarCrossProductTile();
+#endif
+    }
+
+    // 每個平行工作負責的列面板數：8 個面板（64 檔）的報酬約 128KB，留在 L2 中與其後每個面板相乘
+    const size_t kRowBlockPanels = 8;
+    // O(N^2) 的逐列更新每個平行工作處理的列數，避免每列一件工作的排程成本
+    const size_t kRowsPerJob = 64;
+
+    template <class Body>
+    void forEachRow(size_t n, const ParallelBatch &batch, Body body)
+    {
+        batch.run(
+            (n + kRowsPerJob - 1) / kRowsPerJob,
+            [&](size_t job)
+            {
+                for (size_t i = job * kRowsPerJob; i < std::min(n, (job + 1) * kRowsPerJob); ++i)
+                {
+                    body(i);
+                }
+            },
+            [](size_t) {});
+    }
+
+    const double kNaN = std::numeric_limits<double>::quiet_NaN();
+}
+
+CrossProductTile scalarCrossProductTile()
+{
+    return crossProductTile<ScalarOps>;
+}
+
+#ifdef CORRELATION_X86_KERNELS
+CrossProductTile sse2CrossProductTile()
+{
+    return crossProductTile<SSE2Ops>;
+}
+#endif
+
+const char *CorrelationMatrix::kernelName()
+{
+    CrossProductTile tile = bestTile();
+#ifdef CORRELATION_X86_KERNELS
+    if (tile == avx2CrossProductTile())
+    {
+        return "avx2";
+    }
+    if (tile == sse2CrossProductTile())
+    {
+        return "sse2";
+    }
+#endif
+    return "scalar";
+}
+
+CorrelationMatrix::CorrelationMatrix(size_t window) : window(std::max<size_t>(window, 2)) {}
+
+void CorrelationMatrix::compute(const std::vector<CloseSeries> &series, const ParallelBatch &batch)
+{
+    size_t n = series.size();
+    symbols.clear();
+    for (const CloseSeries &s : series)
+    {
+        symbols.push_back(s.symbol);
+    }
+
+    // 交易日曆：聯集的最後 window + 1 天必定落在各股自己的最後 window + 1 天之中
+    std::vector<int> calendar;
+    for (const CloseSeries &s : series)
+    {
+        size_t count = std::min(s.days->size(), window + 1);
+        calendar.insert(calendar.end(), s.days->end() - count, s.days->end());
+    }
+    std::sort(calendar.begin(), calendar.end());
+    calendar.erase(std::unique(calendar.begin(), calendar.end()), calendar.end());
+    if (calendar.size() > window + 1)
+    {
+        calendar.erase(calendar.begin(), calendar.end() - (window + 1));
+    }
+
+    // 每檔股票在各交易日的收盤價（沿用當日或之前最近一筆有效價格），再換成對數報酬；
+    // 報酬尚未減去任何平均，上一次計算留下的 shift 須歸零
+    returns.assign(n * window, 0.0);
+    shift.assign(n, 0.0);
+    gaps.assign(n * window, 1);
+    last_close.assign(n, kNaN);
+    missing.assign(n, 0);
+    head = 0;
+    days.assign(window, 0);
+    size_t offset = window + 1 - std::max<size_t>(calendar.size(), 1); // 日曆不足時前段視為缺值
+    for (size_t t = 1; t < calendar.size(); ++t)
+    {
+        days[offset + t - 1] = calendar[t];
+    }
+    for (size_t s = 0; s < n; ++s)
+    {
+        const std::vector<int> &d = *series[s].days;
+        const std::vector<double> &c = *series[s].close;
+        double prev = kNaN;
+        missing[s] = static_cast<int>(offset);
+        char *gap = &gaps[s * window];
+        for (size_t t = 0; t < calendar.size(); ++t)
+        {
+            // 找到日期 <= calendar[t] 的最後一筆有效價格
+            size_t k = static_cast<size_t>(std::upper_bound(d.begin(), d.end(), calendar[t]) - d.begin());
+            double price = kNaN;
+            while (k > 0 && std::isnan(price))
+            {
+                --k;
+                price = (std::isfinite(c[k]) && c[k] > 0) ? c[k] : kNaN;
+            }
+            if (t > 0)
+            {
+                bool ok = !std::isnan(prev) && !std::isnan(price);
+                returns[s * window + offset + t - 1] = ok ? std::log(price / prev) : 0.0;
+                gap[offset + t - 1] = ok ? 0 : 1;
+                missing[s] += ok ? 0 : 1;
+            }
+            prev = price;
+        }
+        last_close[s] = prev;
+    }
+    recompute(batch);
+}
+
+void CorrelationMatrix::recompute(const ParallelBatch &batch)
+{
+    // 以目前的平均重新置中（shifted data），降低交叉乘積的抵銷誤差
+    size_t n = symbols.size();
+    sums.assign(n, 0.0);
+    for (size_t s = 0; s < n; ++s)
+    {
+        double *r = &returns[s * window];
+        double mean = 0.0;
+        for (size_t t = 0; t < window; ++t)
+        {
+            mean += r[t];
+        }
+        mean /= static_cast<double>(window);
+        for (size_t t = 0; t < window; ++t)
+        {
+            r[t] -= mean;
+        }
+        shift[s] += mean;
+    }
+    crossProducts(batch);
+}
+
+void CorrelationMatrix::crossProducts(const ParallelBatch &batch)
+{
+    size_t n = symbols.size();
+    size_t panels = (n + kCorrelationPanelWidth - 1) / kCorrelationPanelWidth;
+    const size_t w = kCorrelationPanelWidth;
+
+    // 打包：面板 p 的第 t 天為 packed[(p * window + t) * 8 + k]，不足 8 檔補 0；時間依舊到新
+    std::vector<double> packed(panels * window * w, 0.0);
+    for (size_t s = 0; s < n; ++s)
+    {
+        double *panel = &packed[(s / w) * window * w + s % w];
+        for (size_t t = 0; t < window; ++t)
+        {
+            panel[t * w] = slot(s, t);
+        }
+    }
+
+    cross.assign(n * n, 0.0);
+    CrossProductTile tile = bestTile();
+    size_t blocks = (panels + kRowBlockPanels - 1) / kRowBlockPanels;
+    batch.run(
+        blocks,
+        [&](size_t block)
+        {
+            size_t first = block * kRowBlockPanels, last = std::min(panels, first + kRowBlockPanels);
+            double out[kCorrelationPanelWidth * kCorrelationPanelWidth];
+            for (size_t pj = first; pj < panels; ++pj)
+            {
+                const double *b = &packed[pj * window * w];
+                for (size_t pi = first; pi < last && pi <= pj; ++pi)
+                {
+                    tile(&packed[pi * window * w], b, window, out);
+                    // 寫回上三角並鏡射到下三角；不同工作寫入的位置不重疊
+                    for (size_t r = 0; r < w && pi * w + r < n; ++r)
+                    {
+                        size_t i = pi * w + r;
+                        for (size_t c = 0; c < w && pj * w + c < n; ++c)
+                        {
+                            size_t j = pj * w + c;
+                            cross[i * n + j] = out[r * w + c];
+                            cross[j * n + i] = out[r * w + c];
+                        }
+                    }
+                }
+            }
+        },
+        [](size_t) {});
+
+    for (size_t s = 0; s < n; ++s)
+    {
+        double sum = 0.0;
+        for (size_t t = 0; t < window; ++t)
+        {
+            sum += slot(s, t);
+        }
+        sums[s] = sum;
+    }
+}
+
+bool CorrelationMatrix::addDay(int day, const std::vector<double> &closes, const ParallelBatch &batch)
+{
+    size_t n = symbols.size();
+    if (closes.size() != n || day <= days[(head + window - 1) % window])
+    {
+        return false;
+    }
+
+    // 新報酬（已減去 shift）與即將移出的最舊報酬
+    std::vector<double> incoming(n), outgoing(n);
+    for (size_t s = 0; s < n; ++s)
+    {
+        double price = (std::isfinite(closes[s]) && closes[s] > 0) ? closes[s] : last_close[s];
+        bool ok = !std::isnan(last_close[s]) && !std::isnan(price);
+        char &gap = gaps[s * window + head];
+        outgoing[s] = slot(s, 0);
+        incoming[s] = (ok ? std::log(price / last_close[s]) : 0.0) - shift[s];
+        missing[s] += (ok ? 0 : 1) - gap;
+        gap = ok ? 0 : 1;
+        last_close[s] = price;
+    }
+
+    // 秩 2 更新：cross += in in^T - out out^T
+    forEachRow(n, batch,
+               [&](size_t i)
+               {
+                   double *row = &cross[i * n];
+                   double a = incoming[i], b = outgoing[i];
+                   for (size_t j = 0; j < n; ++j)
+                   {
+                       row[j] += a * incoming[j] - b * outgoing[j];
+                   }
+               });
+
+    for (size_t s = 0; s < n; ++s)
+    {
+        sums[s] += incoming[s] - outgoing[s];
+        slot(s, 0) = incoming[s];
+    }
+    days[head] = day;
+    head = (head + 1) % window;
+    return true;
+}
+
+std::vector<int> CorrelationMatrix::windowDays() const
+{
+    std::vector<int> result(window);
+    for (size_t t = 0; t < window; ++t)
+    {
+        result[t] = days[(head + t) % window];
+    }
+    return result;
+}
+
+double CorrelationMatrix::covariance(size_t i, size_t j) const
+{
+    if (!usable(i) || !usable(j))
+    {
+        return kNaN;
+    }
+    size_t n = symbols.size();
+    double count = static_cast<double>(window);
+    return (cross[i * n + j] - sums[i] * sums[j] / count) / (count - 1.0);
+}
+
+double CorrelationMatrix::correlation(size_t i, size_t j) const
+{
+    double var = covariance(i, i) * covariance(j, j);
+    if (std::isnan(var) || var <= 0.0)
+    {
+        return kNaN;
+    }
+    return std::max(-1.0, std::min(1.0, covariance(i, j) / std::sqrt(var)));
+}
+
+void CorrelationMatrix::correlations(std::vector<double> &out, const ParallelBatch &batch) const
+{
+    size_t n = symbols.size();
+    out.assign(n * n, kNaN);
+    forEachRow(n, batch,
+               [&](size_t i)
+               {
+                   for (size_t j = 0; j < n; ++j)
+                   {
+                       out[i * n + j] = correlation(i, j);
+                   }
+               });
+}
@@ -0,0 +1,67 @@
+#ifndef CORRELATION_MATRIX_H
+#define CORRELATION_MATRIX_H
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ParallelBatch;
+
+// 一檔股票依日期升序的收盤價（不擁有資料）
+struct CloseSeries
+{
+    std::string symbol;
+    const std::vector<int> *days = nullptr; // 1970-01-01 起算的日序
+    const std::vector<double> *close = nullptr;
+};
+
+// 全市場滾動報酬相關係數矩陣。
+// compute() 以所有股票日期的聯集為交易日曆，取最近 window 個日報酬（缺價日沿用前一收盤價），
+// 減去各股平均後打包成 8 檔一組的面板，以分塊的交叉乘積核心平行計算 N x N 矩陣；
+// addDay() 加入新的一天並移出最舊的一天，以秩 2 更新在 O(N^2) 內維持矩陣
+class CorrelationMatrix
+{
+public:
+    explicit CorrelationMatrix(size_t window);
+
+    void compute(const std::vector<CloseSeries> &series, const ParallelBatch &batch);
+    // closes 依 compute() 的股票順序，NaN 表示當天沒有價格；day 必須晚於目前最後一天
+    bool addDay(int day, const std::vector<double> &closes, const ParallelBatch &batch);
+    // 以目前視窗重新計算，消除多次增量更新累積的捨入誤差
+    void recompute(const ParallelBatch &batch);
+
+    size_t size() const { return symbols.size(); }
+    size_t getWindow() const { return window; }
+    const std::vector<std::string> &getSymbols() const { return symbols; }
+    // 視窗內各報酬的交易日，由舊到新
+    std::vector<int> windowDays() const;
+    // 視窗內每一天都有報酬的股票才有相關係數
+    bool usable(size_t i) const { return missing[i] == 0; }
+
+    // 樣本共變異數與相關係數；股票不可用或變異數為 0 時回傳 NaN
+    double covariance(size_t i, size_t j) const;
+    double correlation(size_t i, size_t j) const;
+    // 完整的 N x N 相關係數矩陣（列優先）
+    void correlations(std::vector<double> &out, const ParallelBatch &batch) const;
+
+    // 執行期選用的核心名稱：avx2、sse2 或 scalar
+    static const char *kernelName();
+
+private:
+    double &slot(size_t s, size_t t) { return returns[s * window + (head + t) % window]; }
+    double slot(size_t s, size_t t) const { return returns[s * window + (head + t) % window]; }
+    void crossProducts(const ParallelBatch &batch);
+
+    size_t window;
+    std::vector<std::string> symbols;
+    std::vector<int> days;        // 環狀，與 returns 的時間位置相同
+    std::vector<double> returns;  // [股票 * window + 環狀位置]，已減去 shift
+    size_t head = 0;              // 最舊一天的環狀位置
+    std::vector<double> shift;    // 最近一次完整計算時的各股平均報酬
+    std::vector<double> sums;     // 視窗內 Σ (r - shift)
+    std::vector<double> cross;    // N x N，Σ (r_i - shift_i)(r_j - shift_j)
+    std::vector<char> gaps;       // 與 returns 相同位置，1 表示當天沒有報酬（以原始報酬 0 存放）
+    std::vector<double> last_close;
+    std::vector<int> missing;     // 視窗內沒有報酬的天數
+};
+
+#endif
@@ -0,0 +1,34 @@
+// AVX2/FMA 版本的交叉乘積核心：整個翻譯單元以 avx2,fma 目標編譯，
+// 只在 CorrelationMatrix 於執行期確認 CPU 支援後才會被呼叫
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#include "CorrelationKernels.h"
+
+namespace
+{
+    struct AVX2Ops
+    {
+        typedef __m256d vec;
+        static const size_t width = 4;
+
+        static vec zero() { return _mm256_setzero_pd(); }
+        static vec set1(double v) { return _mm256_set1_pd(v); }
+        static vec load(const double *p) { return _mm256_loadu_pd(p); }
+        static void store(double *p, vec v) { _mm256_storeu_pd(p, v); }
+        static vec madd(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+    };
+}
+
+CrossProductTile avx2CrossProductTile()
+{
+    return crossProductTile<AVX2Ops>;
+}
+
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,221 @@
+// 日 K JSON 解析吞吐量測試：DOM 解析 + 排序（原流程）對照串流 DailySeriesReader，
+// 以及分段餵入的 DailySeriesStreamParser（模擬下載中逐段解析）
+// 用法: DailySeriesBenchmark [資料夾=./json.file] [重複次數=5]
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "KLine.h"
+#include "DailySeriesReader.h"
+#include "json.hpp"
+#include "SyntheticCandles.h"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace
+{
+    // 原 KLineMain 流程：建立 DOM、逐筆 stod、配對後依日期字串排序再拆回
+    bool domPath(const std::string &content, std::vector<Candle> &candles, std::vector<std::string> &dates)
+    {
+        json j = json::parse(content, nullptr, false);
+        if (j.is_discarded() || !j.contains("Time Series (Daily)"))
+        {
+            return false;
+        }
+        std::vector<Candle> raw_candles;
+        std::vector<std::string> raw_dates;
+        for (const auto &[date, data] : j["Time Series (Daily)"].items())
+        {
+            try
+            {
+                double open = std::stod(data["1. open"].get<std::string>());
+                double high = std::stod(data["2. high"].get<std::string>());
+                double low = std::stod(data["3. low"].get<std::string>());
+                double close = std::stod(data["4. close"].get<std::string>());
+                long long volume = static_cast<long long>(std::stod(data["5. volume"].get<std::string>()));
+                raw_candles.emplace_back(open, high, low, close, volume);
+                raw_dates.push_back(date);
+            }
+            catch (const std::exception &)
+            {
+                continue;
+            }
+        }
+        std::vector<std::pair<Candle, std::string>> pairs;
+        for (size_t i = 0; i < raw_candles.size(); ++i)
+        {
+            pairs.emplace_back(raw_candles[i], raw_dates[i]);
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const auto &a, const auto &b)
+                  { return a.second < b.second; });
+        candles.clear();
+        dates.clear();
+        for (const auto &pair : pairs)
+        {
+            candles.push_back(pair.first);
+            dates.push_back(pair.second);
+        }
+        return true;
+    }
+
+    // 以固定大小分段餵入增量解析器；chunk 為 0 時每段長度在 1..4096 之間變動
+    bool streamPath(const std::string &content, const std::string &name, size_t chunk, DailySeries &series, std::ostream &errors)
+    {
+        DailySeriesStreamParser parser(name, series, errors);
+        size_t pos = 0, step = 1;
+        while (pos < content.size())
+        {
+            size_t size = chunk > 0 ? chunk : step;
+            size = std::min(size, content.size() - pos);
+            if (!parser.feed(content.data() + pos, size))
+            {
+                break;
+            }
+            pos += size;
+            step = step * 7 % 4093 + 1;
+        }
+        return parser.finish();
+    }
+
+    bool sameSeries(const DailySeries &a, const DailySeries &b)
+    {
+        const CandleColumns &x = a.candles, &y = b.candles;
+        return a.meta_data == b.meta_data && a.days == b.days && x.open == y.open && x.high == y.high &&
+               x.low == y.low && x.close == y.close && x.volume == y.volume;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string folder = argc > 1 ? argv[1] : "./json.file";
+    int repeat = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    std::vector<std::pair<std::string, std::string>> files;
+    size_t total_bytes = 0;
+    for (const auto &entry : fs::directory_iterator(folder))
+    {
+        if (entry.path().extension() != ".json")
+        {
+            continue;
+        }
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        files.emplace_back(entry.path().string(), buffer.str());
+        total_bytes += files.back().second.size();
+    }
+    if (files.empty())
+    {
+        std::cerr << "找不到 JSON 檔案: " << folder << std::endl;
+        return 1;
+    }
+
+    // 先確認兩種流程得到相同的日期與 K 線
+    size_t mismatches = 0, bars = 0;
+    for (const auto &[name, content] : files)
+    {
+        std::vector<Candle> candles;
+        std::vector<std::string> dates;
+        DailySeries series;
+        std::ostringstream errors;
+        bool dom_ok = domPath(content, candles, dates);
+        bool sax_ok = DailySeriesReader::parse(content.data(), content.data() + content.size(), name, series, errors);
+        if (dom_ok != sax_ok || dates != series.dateStrings())
+        {
+            std::cerr << "結果不一致: " << name << std::endl;
+            ++mismatches;
+            continue;
+        }
+        for (size_t i = 0; i < candles.size(); ++i)
+        {
+            const CandleColumns &c = series.candles;
+            if (candles[i].getOpen() != c.open[i] || candles[i].getHigh() != c.high[i] || candles[i].getLow() != c.low[i] ||
+                candles[i].getClose() != c.close[i] || candles[i].getVolume() != c.volume[i])
+            {
+                std::cerr << "K 線不一致: " << name << " 第 " << i << " 筆" << std::endl;
+                ++mismatches;
+                break;
+            }
+        }
+        bars += candles.size();
+
+        // 分段大小不影響結果：逐位元組、變動大小與 16KB（curl 預設緩衝區）都必須與整份解析相同
+        for (size_t chunk : {size_t(1), size_t(0), size_t(16384)})
+        {
+            DailySeries streamed;
+            std::ostringstream stream_errors;
+            if (streamPath(content, name, chunk, streamed, stream_errors) != sax_ok || (sax_ok && !sameSeries(series, streamed)) ||
+                stream_errors.str() != errors.str())
+            {
+                std::cerr << "分段解析不一致: " << name << " 分段 " << chunk << std::endl;
+                ++mismatches;
+            }
+        }
+    }
+
+    // 錯誤輸入：截斷、語法錯誤與缺少 Time Series 的內容必須與整份解析同樣失敗
+    for (const std::string &bad : {files.front().second.substr(0, files.front().second.size() / 2),
+                                   std::string("{\"Meta Data\": {}, }"), std::string("{\"Note\": \"rate limited\"}")})
+    {
+        DailySeries whole, streamed;
+        std::ostringstream errors;
+        if (DailySeriesReader::parse(bad.data(), bad.data() + bad.size(), "bad", whole, errors) !=
+            streamPath(bad, "bad", 0, streamed, errors))
+        {
+            std::cerr << "錯誤輸入處理不一致" << std::endl;
+            ++mismatches;
+        }
+    }
+
+    double dom_ms = elapsedMs([&]
+                              {
+        for (int r = 0; r < repeat; ++r)
+        {
+            for (const auto &file : files)
+            {
+                std::vector<Candle> candles;
+                std::vector<std::string> dates;
+                domPath(file.second, candles, dates);
+            }
+        } });
+    double sax_ms = elapsedMs([&]
+                              {
+        std::ostringstream errors;
+        DailySeries series;
+        for (int r = 0; r < repeat; ++r)
+        {
+            for (const auto &file : files)
+            {
+                DailySeriesReader::parse(file.second.data(), file.second.data() + file.second.size(), file.first, series, errors);
+            }
+        } });
+    double stream_ms = elapsedMs([&]
+                                 {
+        std::ostringstream errors;
+        DailySeries series;
+        for (int r = 0; r < repeat; ++r)
+        {
+            for (const auto &file : files)
+            {
+                streamPath(file.second, file.first, 16384, series, errors);
+            }
+        } });
+
+    double megabytes = static_cast<double>(total_bytes) * repeat / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "files=" << files.size() << " bytes=" << total_bytes << " bars=" << bars << " repeat=" << repeat
+              << " mismatches=" << mismatches << "\n";
+    std::cout << "dom+sort   " << std::setw(9) << dom_ms << " ms  " << std::setw(8) << megabytes / (dom_ms / 1000.0) << " MB/s\n";
+    std::cout << "streaming  " << std::setw(9) << sax_ms << " ms  " << std::setw(8) << megabytes / (sax_ms / 1000.0) << " MB/s"
+              << "  (" << dom_ms / sax_ms << "x)\n";
+    std::cout << "chunked    " << std::setw(9) << stream_ms << " ms  " << std::setw(8) << megabytes / (stream_ms / 1000.0) << " MB/s"
+              << "  (" << dom_ms / stream_ms << "x)\n";
+    return mismatches == 0 ? 0 : 1;
+}
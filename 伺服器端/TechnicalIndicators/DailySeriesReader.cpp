@@ -0,0 +1,869 @@
+#include "DailySeriesReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+using json = nlohmann::json;
+
+namespace
+{
+    // 公曆日期與日序互轉（proleptic Gregorian）
+    int daysFromCivil(int y, int m, int d)
+    {
+        y -= m <= 2;
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const int yoe = y - era * 400;
+        const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    void civilFromDays(int z, int &y, int &m, int &d)
+    {
+        z += 719468;
+        const int era = (z >= 0 ? z : z - 146096) / 146097;
+        const int doe = z - era * 146097;
+        const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp + (mp < 10 ? 3 : -9);
+        y = yoe + era * 400 + (m <= 2);
+    }
+
+    bool readDigits(const char *text, int count, int &value)
+    {
+        value = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (text[i] < '0' || text[i] > '9')
+            {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+    // 與 std::stod 相同的轉換：允許前導空白與尾端多餘字元，完全無法轉換時失敗
+    bool parseNumber(const std::string &text, double &value)
+    {
+        const char *begin = text.c_str();
+        char *end = nullptr;
+        value = std::strtod(begin, &end);
+        return end != begin;
+    }
+
+    // K 線欄位在日 K 物件中的鍵
+    enum Field
+    {
+        FieldOpen,
+        FieldHigh,
+        FieldLow,
+        FieldClose,
+        FieldVolume,
+        FieldCount,
+        FieldOther = FieldCount
+    };
+
+    Field fieldFromKey(const std::string &key)
+    {
+        if (key == "1. open")
+            return FieldOpen;
+        if (key == "2. high")
+            return FieldHigh;
+        if (key == "3. low")
+            return FieldLow;
+        if (key == "4. close")
+            return FieldClose;
+        if (key == "5. volume")
+            return FieldVolume;
+        return FieldOther;
+    }
+
+    // SAX 事件處理：深度 1 為頂層鍵，"Meta Data" 的深度 2 欄位原樣保留，
+    // "Time Series (Daily)" 的深度 2 為日期、深度 3 為 K 線欄位
+    class DailySeriesHandler : public nlohmann::json_sax<json>
+    {
+    public:
+        DailySeriesHandler(const std::string &source, DailySeries &series, std::ostream &errors)
+            : source(source), series(series), errors(errors) {}
+
+        bool sawTimeSeries() const { return saw_time_series; }
+        const std::string &errorMessage() const { return error_message; }
+
+        bool null() override { return value(json()); }
+        bool boolean(bool val) override { return value(json(val)); }
+        bool number_integer(number_integer_t val) override { return value(json(val)); }
+        bool number_unsigned(number_unsigned_t val) override { return value(json(val)); }
+        bool number_float(number_float_t val, const string_t &) override { return value(json(val)); }
+        bool binary(binary_t &) override { return value(json()); }
+
+        bool string(string_t &val) override
+        {
+            if (section == SectionSeries && depth == 3)
+            {
+                if (field != FieldOther)
+                {
+                    fields[field] = std::move(val);
+                    present[field] = true;
+                }
+                return true;
+            }
+            return value(json(std::move(val)));
+        }
+
+        bool start_object(std::size_t) override
+        {
+            ++depth;
+            if (section == SectionSeries && depth == 3)
+            {
+                std::fill(std::begin(present), std::end(present), false);
+            }
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if (section == SectionSeries && depth == 3)
+            {
+                finishRow();
+            }
+            if (depth == 2)
+            {
+                section = SectionNone;
+            }
+            --depth;
+            return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+            ++depth;
+            return true;
+        }
+
+        bool end_array() override
+        {
+            if (depth == 2)
+            {
+                section = SectionNone;
+            }
+            --depth;
+            return true;
+        }
+
+        bool key(string_t &val) override
+        {
+            if (depth == 1)
+            {
+                section = (val == "Meta Data") ? SectionMeta : (val == "Time Series (Daily)" ? SectionSeries : SectionNone);
+                if (section == SectionSeries)
+                {
+                    saw_time_series = true;
+                }
+            }
+            else if (section == SectionMeta && depth == 2)
+            {
+                meta_key = std::move(val);
+            }
+            else if (section == SectionSeries && depth == 2)
+            {
+                date = std::move(val);
+            }
+            else if (section == SectionSeries && depth == 3)
+            {
+                field = fieldFromKey(val);
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override
+        {
+            error_message = ex.what();
+            return false;
+        }
+
+    private:
+        enum Section
+        {
+            SectionNone,
+            SectionMeta,
+            SectionSeries
+        };
+
+        // 純量值：Meta Data 欄位保存，日期下非物件的值視為無法轉換
+        bool value(json &&val)
+        {
+            if (section == SectionMeta && depth == 2)
+            {
+                series.meta_data[meta_key] = std::move(val);
+            }
+            else if (section == SectionSeries && depth == 2)
+            {
+                errors << "無法轉換數據 for " << date << " (" << source << "): 不是物件\n";
+            }
+            return true;
+        }
+
+        void finishRow()
+        {
+            static const char *const names[FieldCount] = {"1. open", "2. high", "3. low", "4. close", "5. volume"};
+            double values[FieldCount];
+            for (int f = 0; f < FieldCount; ++f)
+            {
+                if (!present[f] || !parseNumber(fields[f], values[f]))
+                {
+                    errors << "無法轉換數據 for " << date << " (" << source << "): 欄位 " << names[f] << " 缺少或無效\n";
+                    return;
+                }
+            }
+            int day;
+            if (!parseDayNumber(date.data(), date.size(), day))
+            {
+                errors << "無法轉換數據 for " << date << " (" << source << "): 日期格式錯誤\n";
+                return;
+            }
+            series.days.push_back(day);
+            series.candles.push_back(Candle(values[FieldOpen], values[FieldHigh], values[FieldLow], values[FieldClose],
+                                            static_cast<long long>(values[FieldVolume])));
+        }
+
+        const std::string &source;
+        DailySeries &series;
+        std::ostream &errors;
+        int depth = 0;
+        Section section = SectionNone;
+        bool saw_time_series = false;
+        std::string meta_key, date;
+        Field field = FieldOther;
+        std::string fields[FieldCount];
+        bool present[FieldCount] = {};
+        std::string error_message;
+    };
+
+    // 依日序排列所有欄位
+    template <class T>
+    void permute(std::vector<T> &column, const std::vector<size_t> &order)
+    {
+        std::vector<T> sorted;
+        sorted.reserve(order.size());
+        for (size_t i : order)
+        {
+            sorted.push_back(column[i]);
+        }
+        column.swap(sorted);
+    }
+
+    void orderByDay(DailySeries &series)
+    {
+        const std::vector<int> &days = series.days;
+        size_t n = days.size();
+        bool descending = true, ascending = true;
+        for (size_t i = 1; i < n && (descending || ascending); ++i)
+        {
+            descending = descending && days[i] < days[i - 1];
+            ascending = ascending && days[i] > days[i - 1];
+        }
+        if (ascending)
+        {
+            return;
+        }
+        CandleColumns &c = series.candles;
+        if (descending)
+        {
+            std::reverse(series.days.begin(), series.days.end());
+            std::reverse(c.open.begin(), c.open.end());
+            std::reverse(c.high.begin(), c.high.end());
+            std::reverse(c.low.begin(), c.low.end());
+            std::reverse(c.close.begin(), c.close.end());
+            std::reverse(c.volume.begin(), c.volume.end());
+            return;
+        }
+
+        // 順序不一致：穩定排序後，重複日期只保留最後出現的一筆（與 DOM 覆寫行為相同）
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return days[a] < days[b]; });
+        std::vector<size_t> unique;
+        unique.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i + 1 < n && days[order[i + 1]] == days[order[i]])
+            {
+                continue;
+            }
+            unique.push_back(order[i]);
+        }
+        permute(series.days, unique);
+        permute(c.open, unique);
+        permute(c.high, unique);
+        permute(c.low, unique);
+        permute(c.close, unique);
+        permute(c.volume, unique);
+    }
+}
+
+bool parseDayNumber(const char *text, size_t length, int &day)
+{
+    int y, m, d;
+    if (length != 10 || text[4] != '-' || text[7] != '-' ||
+        !readDigits(text, 4, y) || !readDigits(text + 5, 2, m) || !readDigits(text + 8, 2, d))
+    {
+        return false;
+    }
+    static const int month_days[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m < 1 || m > 12 || d < 1 || d > month_days[m - 1])
+    {
+        return false;
+    }
+    day = daysFromCivil(y, m, d);
+    int check_y, check_m, check_d;
+    civilFromDays(day, check_y, check_m, check_d);
+    return check_m == m && check_d == d; // 排除非閏年的 2 月 29 日
+}
+
+void civilFromDayNumber(int day, int &year, int &month, int &day_of_month)
+{
+    civilFromDays(day, year, month, day_of_month);
+}
+
+std::string formatDayNumber(int day)
+{
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", y, m, d);
+    return buffer;
+}
+
+std::vector<std::string> DailySeries::dateStrings() const
+{
+    std::vector<std::string> dates;
+    dates.reserve(days.size());
+    for (int day : days)
+    {
+        dates.push_back(formatDayNumber(day));
+    }
+    return dates;
+}
+
+void DailySeries::clear()
+{
+    meta_data = json::object();
+    days.clear();
+    candles = CandleColumns();
+}
+
+bool DailySeriesReader::parse(const char *begin, const char *end, const std::string &source,
+                              DailySeries &series, std::ostream &errors)
+{
+    series.clear();
+    // 日 K 物件約 150 位元組，先預留避免欄位反覆擴充
+    size_t estimate = static_cast<size_t>(end - begin) / 150 + 1;
+    series.days.reserve(estimate);
+    series.candles.reserve(estimate);
+
+    DailySeriesHandler handler(source, series, errors);
+    if (!json::sax_parse(begin, end, &handler))
+    {
+        errors << "JSON 解析錯誤 (" << source << "): " << handler.errorMessage() << "\n";
+        return false;
+    }
+    if (!handler.sawTimeSeries())
+    {
+        errors << "JSON 中缺少 'Time Series (Daily)' 鍵 (" << source << ")\n";
+        return false;
+    }
+    orderByDay(series);
+    return true;
+}
+
+bool DailySeriesReader::readFile(const std::string &path, DailySeries &series, std::ostream &errors)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        errors << "無法開啟檔案: " << path << "\n";
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&content[0], static_cast<std::streamsize>(content.size()));
+    return parse(content.data(), content.data() + content.size(), path, series, errors);
+}
+
+// 推送式 JSON 斷詞器：只保留目前未完成的字串或常值，結構字元到達時立即送出 SAX 事件，
+// 與 DailySeriesReader 共用同一個事件處理器，因此欄位、錯誤訊息與排序規則完全相同
+struct DailySeriesStreamParser::Impl
+{
+    enum Expect
+    {
+        ExpectValue,
+        ExpectKey,
+        ExpectColon,
+        ExpectCommaOrEnd,
+        ExpectEnd
+    };
+    enum Token
+    {
+        TokenNone,
+        TokenString,
+        TokenLiteral
+    };
+
+    Impl(const std::string &source, DailySeries &series, std::ostream &errors)
+        : source(source), series(series), errors(errors), handler(this->source, series, errors) {}
+
+    std::string source;
+    DailySeries &series;
+    std::ostream &errors;
+    DailySeriesHandler handler;
+    std::vector<char> containers; // 巢狀的 '{' 與 '['
+    Expect expect = ExpectValue;
+    bool just_opened = false;     // 剛讀到 '{' 或 '['，允許直接結束空容器
+    Token token = TokenNone;
+    bool escaped = false, has_escape = false;
+    std::string text;             // 未完成的字串（未解跳脫）或常值
+    size_t offset = 0;            // 已讀入的位元組數，用於錯誤訊息
+    std::string error;
+
+    bool fail(const std::string &message)
+    {
+        error = message + " at byte " + std::to_string(offset);
+        return false;
+    }
+
+    void afterValue()
+    {
+        expect = containers.empty() ? ExpectEnd : ExpectCommaOrEnd;
+        just_opened = false;
+    }
+
+    static void appendUtf8(std::string &out, unsigned code)
+    {
+        if (code < 0x80)
+        {
+            out.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    static bool readHex(const std::string &s, size_t pos, unsigned &code)
+    {
+        if (pos + 4 > s.size())
+        {
+            return false;
+        }
+        code = 0;
+        for (size_t i = pos; i < pos + 4; ++i)
+        {
+            char c = s[i];
+            int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (digit < 0)
+            {
+                return false;
+            }
+            code = code * 16 + static_cast<unsigned>(digit);
+        }
+        return true;
+    }
+
+    bool unescape(std::string &out)
+    {
+        out.clear();
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] != '\\')
+            {
+                out.push_back(text[i]);
+                continue;
+            }
+            char c = text[++i];
+            switch (c)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(c);
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u':
+            {
+                unsigned code, low;
+                if (!readHex(text, i + 1, code))
+                {
+                    return fail("invalid \\u escape");
+                }
+                i += 4;
+                if (code >= 0xD800 && code <= 0xDBFF)
+                {
+                    // 代理對：必須緊接著低位代理
+                    if (i + 2 >= text.size() || text[i + 1] != '\\' || text[i + 2] != 'u' ||
+                        !readHex(text, i + 3, low) || low < 0xDC00 || low > 0xDFFF)
+                    {
+                        return fail("invalid surrogate pair");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                else if (code >= 0xDC00 && code <= 0xDFFF)
+                {
+                    return fail("invalid surrogate pair");
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+        return true;
+    }
+
+    bool finishString()
+    {
+        std::string value;
+        if (has_escape)
+        {
+            if (!unescape(value))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            value.swap(text);
+        }
+        if (expect == ExpectKey)
+        {
+            handler.key(value);
+            expect = ExpectColon;
+            return true;
+        }
+        handler.string(value);
+        afterValue();
+        return true;
+    }
+
+    // 檢查 JSON 數字格式：-?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+    static bool validNumber(const std::string &s, bool &integer)
+    {
+        size_t i = 0, n = s.size();
+        auto digits = [&]()
+        {
+            size_t start = i;
+            while (i < n && s[i] >= '0' && s[i] <= '9')
+            {
+                ++i;
+            }
+            return i > start;
+        };
+        i += (i < n && s[i] == '-');
+        if (i < n && s[i] == '0')
+        {
+            ++i;
+        }
+        else if (!digits())
+        {
+            return false;
+        }
+        integer = true;
+        if (i < n && s[i] == '.')
+        {
+            ++i;
+            integer = false;
+            if (!digits())
+            {
+                return false;
+            }
+        }
+        if (i < n && (s[i] == 'e' || s[i] == 'E'))
+        {
+            ++i;
+            integer = false;
+            i += (i < n && (s[i] == '+' || s[i] == '-'));
+            if (!digits())
+            {
+                return false;
+            }
+        }
+        return i == n;
+    }
+
+    bool finishLiteral()
+    {
+        bool integer = false;
+        if (text == "true" || text == "false")
+        {
+            handler.boolean(text == "true");
+        }
+        else if (text == "null")
+        {
+            handler.null();
+        }
+        else if (!validNumber(text, integer))
+        {
+            return fail("invalid literal '" + text + "'");
+        }
+        else
+        {
+            // 與 nlohmann 相同：非負整數為 unsigned、負整數為 integer，超出範圍時改為浮點數
+            errno = 0;
+            char *end = nullptr;
+            if (integer && text[0] != '-')
+            {
+                unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+                integer = errno == 0;
+                if (integer)
+                {
+                    handler.number_unsigned(value);
+                }
+            }
+            else if (integer)
+            {
+                long long value = std::strtoll(text.c_str(), &end, 10);
+                integer = errno == 0;
+                if (integer)
+                {
+                    handler.number_integer(value);
+                }
+            }
+            if (!integer)
+            {
+                handler.number_float(std::strtod(text.c_str(), nullptr), text);
+            }
+        }
+        afterValue();
+        return true;
+    }
+
+    bool feed(const char *data, size_t size)
+    {
+        if (!error.empty())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i, ++offset)
+        {
+            char c = data[i];
+            if (token == TokenString)
+            {
+                if (escaped)
+                {
+                    escaped = false;
+                    text.push_back(c);
+                    continue;
+                }
+                // 一次複製到下一個引號或反斜線為止
+                size_t run = i;
+                while (run < size && data[run] != '"' && data[run] != '\\' && static_cast<unsigned char>(data[run]) >= 0x20)
+                {
+                    ++run;
+                }
+                text.append(data + i, run - i);
+                offset += run - i;
+                i = run;
+                if (i == size)
+                {
+                    break;
+                }
+                c = data[i];
+                if (c == '\\')
+                {
+                    escaped = has_escape = true;
+                    text.push_back(c);
+                }
+                else if (c == '"')
+                {
+                    token = TokenNone;
+                    if (!finishString())
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return fail("control character in string");
+                }
+                continue;
+            }
+            if (token == TokenLiteral)
+            {
+                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '.' || c == '+' || c == '-' || c == 'E')
+                {
+                    text.push_back(c);
+                    continue;
+                }
+                token = TokenNone;
+                if (!finishLiteral())
+                {
+                    return false;
+                }
+            }
+
+            switch (c)
+            {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                break;
+            case '"':
+                if (expect != ExpectValue && expect != ExpectKey)
+                {
+                    return fail("unexpected string");
+                }
+                token = TokenString;
+                text.clear();
+                has_escape = just_opened = false;
+                break;
+            case '{':
+            case '[':
+                if (expect != ExpectValue)
+                {
+                    return fail(std::string("unexpected '") + c + "'");
+                }
+                containers.push_back(c);
+                if (c == '{')
+                {
+                    handler.start_object(static_cast<std::size_t>(-1));
+                    expect = ExpectKey;
+                }
+                else
+                {
+                    handler.start_array(static_cast<std::size_t>(-1));
+                }
+                just_opened = true;
+                break;
+            case '}':
+            case ']':
+            {
+                char open = c == '}' ? '{' : '[';
+                Expect empty = c == '}' ? ExpectKey : ExpectValue;
+                if (containers.empty() || containers.back() != open ||
+                    !(expect == ExpectCommaOrEnd || (expect == empty && just_opened)))
+                {
+                    return fail(std::string("unexpected '") + c + "'");
+                }
+                if (c == '}')
+                {
+                    handler.end_object();
+                }
+                else
+                {
+                    handler.end_array();
+                }
+                containers.pop_back();
+                afterValue();
+                break;
+            }
+            case ':':
+                if (expect != ExpectColon)
+                {
+                    return fail("unexpected ':'");
+                }
+                expect = ExpectValue;
+                break;
+            case ',':
+                if (expect != ExpectCommaOrEnd)
+                {
+                    return fail("unexpected ','");
+                }
+                expect = containers.back() == '{' ? ExpectKey : ExpectValue;
+                just_opened = false;
+                break;
+            default:
+                if (expect != ExpectValue || !(c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n'))
+                {
+                    return fail(std::string("unexpected '") + c + "'");
+                }
+                token = TokenLiteral;
+                text.assign(1, c);
+                just_opened = false;
+                break;
+            }
+        }
+        return true;
+    }
+};
+
+DailySeriesStreamParser::DailySeriesStreamParser(const std::string &source, DailySeries &series, std::ostream &errors)
+    : impl(new Impl(source, series, errors))
+{
+    series.clear();
+}
+
+DailySeriesStreamParser::~DailySeriesStreamParser() = default;
+
+bool DailySeriesStreamParser::feed(const char *data, size_t size)
+{
+    return impl->feed(data, size);
+}
+
+bool DailySeriesStreamParser::finish()
+{
+    Impl &p = *impl;
+    if (p.error.empty())
+    {
+        if (p.token == Impl::TokenLiteral)
+        {
+            p.token = Impl::TokenNone;
+            p.finishLiteral();
+        }
+        if (p.error.empty() && (p.token != Impl::TokenNone || p.expect != Impl::ExpectEnd))
+        {
+            p.fail("unexpected end of input");
+        }
+    }
+    if (!p.error.empty())
+    {
+        p.errors << "JSON 解析錯誤 (" << p.source << "): " << p.error << "\n";
+        return false;
+    }
+    if (!p.handler.sawTimeSeries())
+    {
+        p.errors << "JSON 中缺少 'Time Series (Daily)' 鍵 (" << p.source << ")\n";
+        return false;
+    }
+    orderByDay(p.series);
+    return true;
+}
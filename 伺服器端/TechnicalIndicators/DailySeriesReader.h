@@ -0,0 +1,57 @@
+#ifndef DAILY_SERIES_READER_H
+#define DAILY_SERIES_READER_H
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "IndicatorPipeline.h"
+#include "json.hpp"
+
+// 日期字串 YYYY-MM-DD 與整數日序（1970-01-01 為 0）互轉，格式不符時回傳 false
+bool parseDayNumber(const char *text, size_t length, int &day);
+std::string formatDayNumber(int day);
+void civilFromDayNumber(int day, int &year, int &month, int &day_of_month);
+
+// 單一股票的日 K 資料：依日期升序，以整數日序為鍵，K 線欄位連續存放
+struct DailySeries
+{
+    nlohmann::json meta_data = nlohmann::json::object();
+    std::vector<int> days;
+    CandleColumns candles;
+
+    size_t size() const { return days.size(); }
+    std::vector<std::string> dateStrings() const;
+    void clear();
+};
+
+// 串流讀取 Alpha Vantage 日 K JSON：以 SAX 事件直接寫入欄位，不建立 DOM。
+// API 回傳的日期為降序，只需反轉；順序不一致時才排序（重複日期保留最後一筆）
+class DailySeriesReader
+{
+public:
+    // 解析失敗或缺少 "Time Series (Daily)" 時回傳 false；單筆資料無法轉換時略過並寫入 errors
+    static bool parse(const char *begin, const char *end, const std::string &source,
+                      DailySeries &series, std::ostream &errors);
+    static bool readFile(const std::string &path, DailySeries &series, std::ostream &errors);
+};
+
+// 增量解析：內容分段到達時（例如下載中的回應）逐段餵入，每段立即轉成與 DailySeriesReader
+// 相同的 SAX 事件寫入欄位，不需保留完整的原始內容；結果與一次解析整份內容相同
+class DailySeriesStreamParser
+{
+public:
+    // series 先被清空；errors 在 finish() 之前可能已寫入單筆資料的轉換錯誤
+    DailySeriesStreamParser(const std::string &source, DailySeries &series, std::ostream &errors);
+    ~DailySeriesStreamParser();
+
+    // 語法錯誤時回傳 false，之後的輸入都會被忽略
+    bool feed(const char *data, size_t size);
+    // 輸入結束：檢查內容完整並排序日期，失敗條件與 DailySeriesReader::parse 相同
+    bool finish();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+#endif
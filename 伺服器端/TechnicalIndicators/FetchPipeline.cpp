@@ -0,0 +1,222 @@
+// 下載即處理：以 StockDataFetcher 的串流模式抓取日 K，回應邊下載邊由 DailySeriesStreamParser 解析，
+// 完成後直接在記憶體中交給 processSeries 計算指標並寫出 _processed.json（與 KLineMain 相同的輸出與檢查點），
+// 省去原流程的原始檔寫出、重新讀檔與整份解析；原始 JSON 只在需要存檔時由背景執行緒寫入 json.file。
+// 與 alphavantage 相同依 json.file 中快取的最後更新日排程：已是最新交易日的代碼不抓取，直接以快取更新輸出；
+// 只缺少少數交易日的抓 compact，合併進快取的完整歷史後才計算與存檔；其餘抓完整歷史
+// 用法：FetchPipeline [--apikey 金鑰] [--base-url 網址] [--rpm N] [--burst N] [--concurrency N] [--cainfo 憑證檔]
+//                     [--today YYYY-MM-DD] [--compact-days 交易日數] [--force-full]
+//                     [--no-archive] [--compact] [--columnar] [--full] [--timeframes] 代碼...
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include "DailySeriesReader.h"
+#include "SymbolProcessor.h"
+#include "StockDataFetcher.h"
+#include "FetchScheduler.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // 單一代碼的回應處理者：下載片段直接餵入增量解析器，傳輸完成後計算指標並寫出結果。
+    // finish() 在抓取迴圈的執行緒上執行，單檔處理只需數毫秒，相較 API 限速可忽略
+    class IndicatorStream : public ResponseStream
+    {
+    public:
+        IndicatorStream(const std::string &source, const std::string &output_folder, const OutputOptions &options,
+                        StageTimings &totals)
+            : source(source), output_folder(output_folder), options(options), totals(totals),
+              parser(source, series, errors) {}
+
+        bool write(const char *data, size_t size) override
+        {
+            return parser.feed(data, size);
+        }
+
+        bool finish(bool ok) override
+        {
+            if (!ok)
+            {
+                return false;
+            }
+            StageClock clock;
+            if (!parser.finish())
+            {
+                std::cerr << errors.str() << std::flush;
+                return false;
+            }
+            double parse_ms = clock.lap();
+            FileResult result = processSeries(source, series, output_folder, options);
+            result.timings.parse += parse_ms;
+            std::cout << result.output << std::flush;
+            std::cerr << errors.str() << result.errors << std::flush;
+            totals.add(result.timings);
+            return result.errors.empty();
+        }
+
+    private:
+        std::string source;
+        const std::string &output_folder;
+        const OutputOptions &options;
+        StageTimings &totals;
+        DailySeries series;
+        std::ostringstream errors;
+        DailySeriesStreamParser parser;
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    // 與 KLineMain 相同的資料夾：原始 JSON 存檔於 json.file，指標輸出於 output_json
+    std::string input_folder_path = "./json.file";
+    std::string output_folder_path = "./output_json";
+
+    const char *env_key = std::getenv("ALPHAVANTAGE_API_KEY");
+    std::string api_key = env_key ? env_key : "";
+    FetchOptions fetch;
+    fetch.outputDir = input_folder_path;
+    OutputOptions options;
+    std::string today = FetchScheduler::latestTradingDay();
+    int compact_days = 90;
+    bool force_full = false;
+    std::vector<std::string> symbols;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--apikey" && has_value)
+        {
+            api_key = argv[++i];
+        }
+        else if (arg == "--base-url" && has_value)
+        {
+            fetch.baseUrl = argv[++i];
+        }
+        else if (arg == "--rpm" && has_value)
+        {
+            fetch.requestsPerMinute = std::atof(argv[++i]);
+        }
+        else if (arg == "--burst" && has_value)
+        {
+            fetch.burst = std::atof(argv[++i]);
+        }
+        else if (arg == "--concurrency" && has_value)
+        {
+            fetch.maxConcurrency = std::atoi(argv[++i]);
+        }
+        else if (arg == "--cainfo" && has_value)
+        {
+            fetch.caInfo = argv[++i];
+        }
+        else if (arg == "--today" && has_value)
+        {
+            today = argv[++i];
+        }
+        else if (arg == "--compact-days" && has_value)
+        {
+            compact_days = std::atoi(argv[++i]);
+        }
+        else if (arg == "--force-full")
+        {
+            force_full = true;
+        }
+        else if (arg == "--no-archive")
+        {
+            fetch.archive = false;
+        }
+        else if (arg == "--compact")
+        {
+            options.style = ProcessedJsonWriter::Style::Compact;
+        }
+        else if (arg == "--columnar")
+        {
+            options.columnar = true;
+        }
+        else if (arg == "--full")
+        {
+            options.incremental = false;
+        }
+        else if (arg == "--timeframes")
+        {
+            options.timeframes = true;
+        }
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            std::cerr << "未知參數: " << arg << std::endl;
+            return 1;
+        }
+        else
+        {
+            symbols.push_back(arg);
+        }
+    }
+    if (api_key.empty() || symbols.empty())
+    {
+        std::cerr << "需要 API 金鑰（--apikey 或環境變數 ALPHAVANTAGE_API_KEY）與至少一個股票代碼" << std::endl;
+        return 1;
+    }
+    for (const std::string &folder : {input_folder_path, output_folder_path})
+    {
+        if (!fs::exists(folder))
+        {
+            fs::create_directory(folder);
+            std::cout << "Created folder: " << folder << std::endl;
+        }
+    }
+
+    // 依快取排程：compact 回應由抓取端合併進快取的完整歷史，再交給 IndicatorStream
+    std::vector<FetchRequest> requests;
+    std::vector<std::string> cached;
+    FetchScheduler scheduler(input_folder_path, compact_days);
+    for (const FetchPlan &plan : scheduler.planAll(symbols, today))
+    {
+        if (force_full || plan.mode == FetchMode::Full)
+        {
+            requests.push_back({plan.symbol, OutputSize::Full, false});
+        }
+        else if (plan.mode == FetchMode::Compact)
+        {
+            requests.push_back({plan.symbol, OutputSize::Compact, true});
+        }
+        else
+        {
+            cached.push_back(plan.symbol);
+        }
+    }
+    std::cout << "[LOG] 最新交易日 " << today << "：略過 " << cached.size() << "，抓取 " << requests.size() << std::endl;
+
+    StageTimings totals;
+    StageClock wall;
+    StockDataFetcher fetcher(api_key, fetch);
+    fetcher.setResponseStream([&](const std::string &symbol)
+                              {
+        // 與 KLineMain 讀取 json.file 時相同的來源路徑，輸出檔名與檢查點因此一致
+        std::string source = (fs::path(input_folder_path) / ("stock_data_" + symbol + ".json")).string();
+        return std::unique_ptr<ResponseStream>(new IndicatorStream(source, output_folder_path, options, totals)); });
+    size_t processed = requests.empty() ? 0 : fetcher.fetchAndSaveAll(requests);
+
+    // 已是最新的代碼不抓取，直接以快取檔更新輸出（檢查點一致時不需重算）
+    size_t cached_ok = 0;
+    for (const std::string &symbol : cached)
+    {
+        std::string source = (fs::path(input_folder_path) / ("stock_data_" + symbol + ".json")).string();
+        FileResult result = processFile(source, output_folder_path, options);
+        std::cout << result.output << std::flush;
+        std::cerr << result.errors << std::flush;
+        totals.add(result.timings);
+        cached_ok += result.errors.empty() ? 1 : 0;
+    }
+    processed += cached_ok;
+    double wall_ms = wall.lap();
+
+    std::clog << std::fixed << std::setprecision(1)
+              << "[TIMING] symbols=" << symbols.size() << " processed=" << processed << " wall=" << wall_ms << "ms"
+              << " parse=" << totals.parse << "ms compute=" << totals.compute << "ms serialize=" << totals.serialize
+              << "ms write=" << totals.write << "ms" << std::endl;
+    return processed == symbols.size() ? 0 : 1;
+}
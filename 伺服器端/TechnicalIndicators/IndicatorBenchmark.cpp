@@ -0,0 +1,254 @@
+// 指標微基準測試：以幾何布朗運動產生模擬 K 線，量測 Tech_Analysis 各指標與 generateTradeSignals
+// 每根 K 線的耗時（ns/bar）與動態配置次數（allocs/bar），結果以 JSON 輸出供跨版本追蹤效能退化。
+// 逐索引版本與整段序列版本在抽樣索引上互相比對，摘要寫到 stderr
+// 用法：IndicatorBenchmark [K 線數=100000] [股票數=1] [重複次數=3] [逐索引抽樣數=200] [輸出檔=標準輸出]
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include "KLine.h"
+#include "Tech_Analysis.h"
+#include "TradeSignal.h"
+#include "json.hpp"
+#define SYNTHETIC_CANDLES_COUNT_ALLOCATIONS
+#include "SyntheticCandles.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+    // 一檔股票的模擬資料；每檔使用獨立種子，逐檔產生以免大量 K 線同時佔用記憶體
+    struct Bars
+    {
+        std::vector<Candle> candles;
+        std::vector<double> closes;
+    };
+
+    Bars generateBars(size_t n, size_t symbol)
+    {
+        SyntheticCandles generator(20240701 + symbol);
+        generator.reset(SyntheticCandles::startPrice(symbol));
+        Bars bars;
+        bars.candles.reserve(n);
+        bars.closes.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            SyntheticCandle c = generator.next();
+            bars.candles.push_back(Candle(c.open, c.high, c.low, c.close, c.volume, c.open));
+            bars.closes.push_back(c.close);
+        }
+        return bars;
+    }
+
+    // 單一量測項目的累計值；calls 為實際計算的 K 線數（逐索引版本為呼叫次數）
+    struct Measurement
+    {
+        std::string name;
+        std::string kind; // "series" 為整段計算，"per-index" 為單一索引計算
+        double seconds = 0.0;
+        size_t calls = 0;
+        size_t allocs = 0;
+        size_t bytes = 0;
+    };
+
+    // 執行 repeat 次取最快的耗時，配置次數以單次執行計
+    void measure(Measurement &m, size_t calls, int repeat, const std::function<void()> &body)
+    {
+        double best = 1e300;
+        size_t allocs = 0, bytes = 0;
+        for (int run = 0; run < repeat; ++run)
+        {
+            size_t count_before = g_allocations.count, bytes_before = g_allocations.bytes;
+            best = std::min(best, elapsedMs(body) / 1000.0);
+            allocs = g_allocations.count - count_before;
+            bytes = g_allocations.bytes - bytes_before;
+        }
+        m.seconds += best;
+        m.calls += calls;
+        m.allocs += allocs;
+        m.bytes += bytes;
+    }
+
+    // first..last 之間平均取 count 個索引
+    std::vector<int> sampleIndices(int first, int last, size_t count)
+    {
+        std::vector<int> result;
+        if (last < first || count == 0)
+        {
+            return result;
+        }
+        size_t span = static_cast<size_t>(last - first) + 1;
+        count = std::min(count, span);
+        for (size_t k = 0; k < count; ++k)
+        {
+            result.push_back(first + static_cast<int>(count == 1 ? span - 1 : k * (span - 1) / (count - 1)));
+        }
+        return result;
+    }
+
+    bool near(double a, double b)
+    {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+    }
+
+    // 防止編譯器省略結果未被使用的計算
+    volatile double g_sink = 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t bars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t symbols = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+    int repeat = argc > 3 ? std::max(1, std::atoi(argv[3])) : 3;
+    size_t sample = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 200;
+    std::string output = argc > 5 ? argv[5] : "";
+
+    SignalConfig config;
+    const int ma_period = 20, kd_period = 9, kd_sma = 3;
+    const int lookback = config.ema_slow + config.signal_period - 1;
+    const std::vector<int> ma_periods = {5, 20, 60};
+
+    enum
+    {
+        MovingAverage,
+        MovingAverages,
+        MACD,
+        MACDSeries,
+        KD,
+        KDSeries,
+        RSI,
+        RSISeries,
+        Signals,
+        Count
+    };
+    std::vector<Measurement> results(Count);
+    results[MovingAverage] = {"Tech_Analysis::movingAverage", "per-index"};
+    results[MovingAverages] = {"Tech_Analysis::movingAverages", "series"};
+    results[MACD] = {"MACDResult::macd", "per-index"};
+    results[MACDSeries] = {"MACDResult::macdSeries", "series"};
+    results[KD] = {"KDResult::stochasticKD", "per-index"};
+    results[KDSeries] = {"KDResult::stochasticKDSeries", "series"};
+    results[RSI] = {"RSIResult::rsi", "per-index"};
+    results[RSISeries] = {"RSIResult::rsiSeries", "series"};
+    results[Signals] = {"generateTradeSignals", "series"};
+
+    size_t mismatches = 0, signal_count = 0;
+    for (size_t s = 0; s < symbols; ++s)
+    {
+        Bars data = generateBars(bars, s);
+        const std::vector<Candle> &candles = data.candles;
+        const std::vector<double> &closes = data.closes;
+        int last = static_cast<int>(bars) - 1;
+
+        // movingAverage、stochasticKD 與 Simple RSI 的單一索引成本為 O(週期)，逐一計算每根 K 線；
+        // MACD 的單一索引版本自序列開頭遞推，成本為 O(索引)，只計算抽樣索引
+        measure(results[MovingAverage], bars - std::min<size_t>(bars, ma_period - 1), repeat, [&]
+                {
+                    double sum = 0.0;
+                    for (int i = ma_period - 1; i <= last; ++i)
+                    {
+                        sum += Tech_Analysis::movingAverage(closes, ma_period, i);
+                    }
+                    g_sink = sum; });
+        std::vector<std::vector<double>> ma_series;
+        measure(results[MovingAverages], bars, repeat, [&]
+                { ma_series = Tech_Analysis::movingAverages(closes, ma_periods); });
+
+        std::vector<int> macd_indices = sampleIndices(config.ema_slow - 1, last, sample);
+        measure(results[MACD], macd_indices.size(), repeat, [&]
+                {
+                    double sum = 0.0;
+                    for (int i : macd_indices)
+                    {
+                        sum += MACDResult::macd(closes, i, config).histogram;
+                    }
+                    g_sink = sum; });
+        std::vector<MACDResult> macd_series;
+        measure(results[MACDSeries], bars, repeat, [&]
+                { macd_series = MACDResult::macdSeries(closes, config); });
+
+        measure(results[KD], bars - std::min<size_t>(bars, kd_period - 1), repeat, [&]
+                {
+                    double sum = 0.0;
+                    for (int i = kd_period - 1; i <= last; ++i)
+                    {
+                        sum += KDResult::stochasticKD(candles, kd_period, kd_sma, i).k;
+                    }
+                    g_sink = sum; });
+        std::vector<KDResult> kd_series;
+        measure(results[KDSeries], bars, repeat, [&]
+                { kd_series = KDResult::stochasticKDSeries(candles, kd_period, kd_sma); });
+
+        measure(results[RSI], bars - std::min<size_t>(bars, config.rsi_period), repeat, [&]
+                {
+                    double sum = 0.0;
+                    for (int i = config.rsi_period; i <= last; ++i)
+                    {
+                        sum += RSIResult::rsi(closes, config.rsi_period, i, config);
+                    }
+                    g_sink = sum; });
+        std::vector<double> rsi_series;
+        measure(results[RSISeries], bars, repeat, [&]
+                { rsi_series = RSIResult::rsiSeries(closes, config.rsi_period, config); });
+
+        // 含 KD 與 RSI 序列計算的便利版本，MACD 沿用已算好的快取
+        std::vector<TradeSignal> signals;
+        measure(results[Signals], bars, repeat, [&]
+                { signals = generateTradeSignals(candles, closes, config, lookback, macd_series); });
+        signal_count += signals.size();
+
+        // 逐索引與整段序列版本在抽樣索引上必須一致
+        for (int i : sampleIndices(std::max(lookback, ma_period), last, sample))
+        {
+            MACDResult macd = MACDResult::macd(closes, i, config);
+            KDResult kd = KDResult::stochasticKD(candles, kd_period, kd_sma, i);
+            mismatches += !near(Tech_Analysis::movingAverage(closes, ma_period, i), ma_series[1][i]);
+            mismatches += !near(macd.histogram, macd_series[i].histogram);
+            mismatches += !near(kd.k, kd_series[i].k) || !near(kd.d, kd_series[i].d);
+            mismatches += !near(RSIResult::rsi(closes, config.rsi_period, i, config), rsi_series[i]);
+        }
+    }
+
+    json report;
+    report["benchmark"] = "IndicatorBenchmark";
+    report["compiler"] = __VERSION__;
+    report["bars_per_symbol"] = bars;
+    report["symbols"] = symbols;
+    report["repeat"] = repeat;
+    report["per_index_sample"] = sample;
+    report["signals"] = signal_count;
+    report["consistent"] = mismatches == 0;
+    report["kernels"] = json::array();
+    for (const Measurement &m : results)
+    {
+        double calls = static_cast<double>(std::max<size_t>(m.calls, 1));
+        report["kernels"].push_back({{"name", m.name},
+                                     {"kind", m.kind},
+                                     {"bars", m.calls},
+                                     {"seconds", m.seconds},
+                                     {"ns_per_bar", m.seconds * 1e9 / calls},
+                                     {"allocs_per_bar", m.allocs / calls},
+                                     {"bytes_per_bar", m.bytes / calls}});
+    }
+
+    if (output.empty())
+    {
+        std::cout << report.dump(2) << std::endl;
+    }
+    else
+    {
+        std::ofstream file(output);
+        if (!file)
+        {
+            std::cerr << "無法寫入 " << output << "\n";
+            return 1;
+        }
+        file << report.dump(2) << std::endl;
+    }
+    std::cerr << (mismatches == 0 ? "結果一致" : "結果不一致: " + std::to_string(mismatches)) << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
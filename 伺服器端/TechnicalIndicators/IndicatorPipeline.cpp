@@ -0,0 +1,111 @@
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "CompactCandles.h"
+
+void CandleColumns::reserve(size_t n)
+{
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+}
+
+void CandleColumns::push_back(const Candle &candle)
+{
+    open.push_back(candle.getOpen());
+    high.push_back(candle.getHigh());
+    low.push_back(candle.getLow());
+    close.push_back(candle.getClose());
+    volume.push_back(candle.getVolume());
+}
+
+CandleColumns CandleColumns::fromCandles(const std::vector<Candle> &candles)
+{
+    CandleColumns columns;
+    columns.reserve(candles.size());
+    for (const auto &candle : candles)
+    {
+        columns.push_back(candle);
+    }
+    return columns;
+}
+
+void IndicatorColumns::resize(size_t n)
+{
+    for (auto *column : {&ma5, &ma10, &ma20, &k, &d, &rsi, &macd_line, &signal_line, &histogram, &price_change_percent,
+                         &bollinger_upper, &bollinger_lower, &atr, &obv, &vwap})
+    {
+        column->assign(n, 0.0);
+    }
+    signal.assign(n, 0);
+    strength.assign(n, 0);
+    valid.assign(n, 0);
+}
+
+IndicatorPipeline::IndicatorPipeline(const SignalConfig &config) : config(config) {}
+
+void IndicatorPipeline::run(const CandleColumns &input, IndicatorColumns &output, int lookback) const
+{
+    IndicatorState state(config, lookback);
+    run(input, output, state);
+}
+
+namespace
+{
+    // high(i)/low(i)/close(i) 回傳第 i 根的價格，volume 為成交量欄位
+    template <class High, class Low, class Close, class Volume>
+    void runRows(size_t n, High high, Low low, Close close, const Volume &volume,
+                 IndicatorColumns &output, IndicatorState &state)
+    {
+        output.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            IndicatorRow row = state.advance(high(i), low(i), close(i), volume[i]);
+            output.ma5[i] = row.ma5;
+            output.ma10[i] = row.ma10;
+            output.ma20[i] = row.ma20;
+            output.k[i] = row.k;
+            output.d[i] = row.d;
+            output.rsi[i] = row.rsi;
+            output.macd_line[i] = row.macd_line;
+            output.signal_line[i] = row.signal_line;
+            output.histogram[i] = row.histogram;
+            output.price_change_percent[i] = row.price_change_percent;
+            output.bollinger_upper[i] = row.bollinger_upper;
+            output.bollinger_lower[i] = row.bollinger_lower;
+            output.atr[i] = row.atr;
+            output.obv[i] = row.obv;
+            output.vwap[i] = row.vwap;
+            output.signal[i] = row.code.signal;
+            output.strength[i] = row.code.strength;
+            output.valid[i] = row.valid;
+        }
+    }
+}
+
+void IndicatorPipeline::run(const CandleColumns &input, IndicatorColumns &output, IndicatorState &state) const
+{
+    runRows(
+        input.size(),
+        [&](size_t i)
+        { return input.high[i]; },
+        [&](size_t i)
+        { return input.low[i]; },
+        [&](size_t i)
+        { return input.close[i]; },
+        input.volume, output, state);
+}
+
+void IndicatorPipeline::run(const CompactCandleColumns &input, IndicatorColumns &output, IndicatorState &state) const
+{
+    runRows(
+        input.size(),
+        [&](size_t i)
+        { return input.price(input.high[i]); },
+        [&](size_t i)
+        { return input.price(input.low[i]); },
+        [&](size_t i)
+        { return input.price(input.close[i]); },
+        input.volume, output, state);
+}
@@ -0,0 +1,76 @@
+#ifndef INDICATOR_PIPELINE_H
+#define INDICATOR_PIPELINE_H
+#include <cstdint>
+#include <vector>
+#include "KLine.h"
+#include "TradeSignal.h"
+
+// 依欄位連續存放的 K 線資料（struct-of-arrays），各欄位長度相同
+struct CandleColumns
+{
+    std::vector<double> open, high, low, close;
+    std::vector<long long> volume;
+
+    size_t size() const { return close.size(); }
+    void reserve(size_t n);
+    void push_back(const Candle &candle);
+    static CandleColumns fromCandles(const std::vector<Candle> &candles);
+};
+
+// IndicatorRow::valid 與 IndicatorColumns::valid 的位元：該列的指標已完成暖機且輸入皆有效。
+// 無效的指標值仍以 0 輸出，需要區分「0」與「沒有值」時以此判斷
+enum IndicatorValidity : uint32_t
+{
+    ValidMA5 = 1u << 0,
+    ValidMA10 = 1u << 1,
+    ValidMA20 = 1u << 2,
+    ValidK = 1u << 3,
+    ValidD = 1u << 4,
+    ValidRSI = 1u << 5,
+    ValidMACDLine = 1u << 6,
+    ValidSignalLine = 1u << 7, // 訊號線與柱狀體
+    ValidPriceChange = 1u << 8,
+    ValidBollinger = 1u << 9,
+    ValidATR = 1u << 10,
+    ValidOBV = 1u << 11,
+    ValidVWAP = 1u << 12,
+    ValidSignal = 1u << 13 // 已過 lookback，交易訊號與強度有評分
+};
+
+// 所有技術指標的輸出欄位，由 IndicatorPipeline 預先配置為與輸入等長
+struct IndicatorColumns
+{
+    std::vector<double> ma5, ma10, ma20;
+    std::vector<double> k, d;
+    std::vector<double> rsi;
+    std::vector<double> macd_line, signal_line, histogram;
+    std::vector<double> price_change_percent;
+    std::vector<double> bollinger_upper, bollinger_lower; // 布林通道 (20, 2)
+    std::vector<double> atr, obv, vwap;                   // ATR(14)、OBV、20 日滾動 VWAP
+    std::vector<signed char> signal, strength; // 編碼同 SignalCode
+    std::vector<uint32_t> valid;               // 每列的 IndicatorValidity 位元
+
+    size_t size() const { return ma5.size(); }
+    void resize(size_t n);
+};
+
+class IndicatorState;
+struct CompactCandleColumns;
+
+// 融合式指標管線：單次走訪 K 線欄位，同時更新 MA/KD/RSI/MACD 與交易訊號
+class IndicatorPipeline
+{
+public:
+    explicit IndicatorPipeline(const SignalConfig &config);
+    // 從頭計算，lookback 之前的 K 線不產生交易訊號
+    void run(const CandleColumns &input, IndicatorColumns &output, int lookback) const;
+    // 從 state 目前的位置接續計算，結束時 state 停在最後一根 K 線之後
+    void run(const CandleColumns &input, IndicatorColumns &output, IndicatorState &state) const;
+    // 直接讀取緊湊欄位（定點價格逐列還原），結果與 CandleColumns 版本相同
+    void run(const CompactCandleColumns &input, IndicatorColumns &output, IndicatorState &state) const;
+
+private:
+    SignalConfig config;
+};
+
+#endif
@@ -0,0 +1,389 @@
+#include "IndicatorState.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using json = nlohmann::json;
+
+namespace
+{
+    const int kStateVersion = 2;
+
+    // JSON 不支援 NaN，無效值以 null 表示
+    json doubleToJson(double value)
+    {
+        return std::isnan(value) ? json(nullptr) : json(value);
+    }
+
+    double doubleFromJson(const json &value)
+    {
+        return value.is_null() ? std::numeric_limits<double>::quiet_NaN() : value.get<double>();
+    }
+
+    json doublesToJson(const std::vector<double> &values)
+    {
+        json array = json::array();
+        for (double value : values)
+        {
+            array.push_back(doubleToJson(value));
+        }
+        return array;
+    }
+
+    std::vector<double> doublesFromJson(const json &array)
+    {
+        std::vector<double> values;
+        values.reserve(array.size());
+        for (const auto &value : array)
+        {
+            values.push_back(doubleFromJson(value));
+        }
+        return values;
+    }
+}
+
+IndicatorState::IndicatorState(const SignalConfig &config, int lookback)
+    : config(config),
+      lookback(lookback),
+      index(0),
+      prev_close(0.0),
+      moving_averages({5, 10, 20}),
+      stochastic(9, 3),
+      rsi_state(config.rsi_period, config.rsi_mode),
+      macd_state(config),
+      bollinger(20, 2.0),
+      atr_state(14),
+      vwap_state(20)
+{
+}
+
+IndicatorRow IndicatorState::advance(double high, double low, double close, long long volume)
+{
+    int i = index++;
+    IndicatorRow row;
+
+    double ma[3];
+    moving_averages.update(close, ma);
+    row.ma5 = ma[0];
+    row.ma10 = ma[1];
+    row.ma20 = ma[2];
+
+    KDResult kd = stochastic.update(high, low, close);
+    row.k = kd.getK();
+    row.d = kd.getD();
+
+    row.rsi = rsi_state.update(close);
+
+    MACDResult macd = macd_state.update(close);
+    row.macd_line = macd.macdLine;
+    row.signal_line = macd.signalLine;
+    row.histogram = macd.histogram;
+
+    BollingerResult bands = bollinger.update(close);
+    row.bollinger_upper = bands.upper;
+    row.bollinger_lower = bands.lower;
+    row.atr = atr_state.update(high, low, close);
+    row.obv = obv_state.update(close, volume);
+    row.vwap = vwap_state.update(high, low, close, volume);
+
+    if (i > 0)
+    {
+        row.price_change_percent = (prev_close > 0) ? (close - prev_close) / prev_close * 100.0 : 0.0;
+    }
+    bool change_valid = i > 0 && prev_close > 0 && std::isfinite(close) && std::isfinite(row.price_change_percent);
+    prev_close = close;
+
+    // 有效位元直接取自各指標狀態，暖機長度與無效輸入的處理只定義在狀態本身
+    auto bit = [](bool ready, uint32_t flag)
+    { return ready ? flag : 0u; };
+    row.valid = bit(moving_averages.ready(0), ValidMA5) | bit(moving_averages.ready(1), ValidMA10) |
+                bit(moving_averages.ready(2), ValidMA20) | bit(stochastic.kReady(), ValidK) |
+                bit(stochastic.dReady(), ValidD) | bit(rsi_state.ready(), ValidRSI) |
+                bit(macd_state.lineReady(), ValidMACDLine) | bit(macd_state.signalReady(), ValidSignalLine) |
+                bit(change_valid, ValidPriceChange) | bit(bollinger.ready(), ValidBollinger) |
+                bit(atr_state.ready(), ValidATR) | bit(obv_state.ready(), ValidOBV) |
+                bit(vwap_state.ready(), ValidVWAP) | bit(i >= lookback, ValidSignal);
+
+    // 訊號只依賴當根與前一根；第一根沒有前一根時以自身代替
+    if (i >= lookback)
+    {
+        const IndicatorRow &prev = (i > 0) ? prev_row : row;
+        row.code = scoreSignal(i, config,
+                               macd, MACDResult(prev.macd_line, prev.signal_line, prev.histogram),
+                               kd, KDResult(prev.k, prev.d),
+                               row.rsi);
+    }
+    prev_row = row;
+    return row;
+}
+
+KLineRecord IndicatorState::update(const std::string &date, const Candle &candle)
+{
+    IndicatorRow row = advance(candle.getHigh(), candle.getLow(), candle.getClose(), candle.getVolume());
+    last_date = date;
+
+    KLine kline(candle);
+    kline.setPriceChangePercent(row.price_change_percent);
+    return KLineRecord(date, kline,
+                       row.ma5, row.ma10, row.ma20,
+                       row.k, row.d,
+                       row.rsi,
+                       row.macd_line, row.signal_line, row.histogram,
+                       row.bollinger_upper, row.bollinger_lower, row.atr, row.obv, row.vwap,
+                       signalText(row.code.signal), strengthText(row.code.strength));
+}
+
+json IndicatorState::toJson() const
+{
+    auto rolling = [](const RollingSum &w)
+    {
+        return json{{"period", w.period}, {"count", w.count}, {"head", w.head}, {"invalid", w.invalid}, {"nonzero", w.nonzero}, {"total", w.total}, {"compensation", w.compensation}, {"values", doublesToJson(w.values)}};
+    };
+    auto monotonic = [](const MonotonicWindow &w)
+    {
+        return json{{"period", w.period}, {"kind", static_cast<int>(w.kind)}, {"index", w.index}, {"head", w.head}, {"size", w.size}, {"positions", w.positions}, {"values", doublesToJson(w.values)}};
+    };
+    auto variance = [](const RollingVariance &w)
+    {
+        return json{{"period", w.period}, {"count", w.count}, {"head", w.head}, {"invalid", w.invalid}, {"valid_count", w.valid_count}, {"average", w.average}, {"m2", w.m2}, {"values", doublesToJson(w.values)}};
+    };
+    auto exponential = [](const ExponentialAverage &w)
+    {
+        return json{{"period", w.period}, {"seed_count", w.seed_count}, {"seed_sum", w.seed_sum}, {"current", w.current}};
+    };
+
+    json ma = json::array();
+    for (const auto &window : moving_averages.windows)
+    {
+        ma.push_back(rolling(window));
+    }
+
+    json j;
+    j["version"] = kStateVersion;
+    j["config"] = {{"price_change_threshold", config.price_change_threshold},
+                   {"ema_fast", config.ema_fast},
+                   {"ema_slow", config.ema_slow},
+                   {"signal_period", config.signal_period},
+                   {"rsi_overbought", config.rsi_overbought},
+                   {"rsi_oversold", config.rsi_oversold},
+                   {"rsi_period", config.rsi_period},
+                   {"rsi_mode", config.rsi_mode == RSIMode::Wilder ? "wilder" : "simple"}};
+    j["lookback"] = lookback;
+    j["index"] = index;
+    j["prev_close"] = prev_close;
+    j["last_date"] = last_date;
+    j["moving_averages"] = ma;
+    j["stochastic"] = {{"period", stochastic.period},
+                       {"sma_period", stochastic.sma_period},
+                       {"index", stochastic.index},
+                       {"lowest_low", monotonic(stochastic.lowest_low)},
+                       {"highest_high", monotonic(stochastic.highest_high)},
+                       {"price_flags", rolling(stochastic.price_flags)},
+                       {"k_window", rolling(stochastic.k_window)}};
+    j["rsi"] = {{"index", rsi_state.index},
+                {"prev_close", rsi_state.prev_close},
+                {"gains", rolling(rsi_state.gains)},
+                {"losses", rolling(rsi_state.losses)},
+                {"wilder_count", rsi_state.wilder_count},
+                {"avg_gain", rsi_state.avg_gain},
+                {"avg_loss", rsi_state.avg_loss}};
+    j["macd"] = {{"index", macd_state.index},
+                 {"valid", macd_state.valid},
+                 {"ema_fast", macd_state.ema_fast},
+                 {"ema_slow", macd_state.ema_slow},
+                 {"macd_window", doublesToJson(macd_state.macd_window)},
+                 {"macd_window_sum", macd_state.macd_window_sum},
+                 {"signal_ema", macd_state.signal_ema},
+                 {"signal_decay", macd_state.signal_decay}};
+    j["bollinger"] = {{"width", bollinger.width}, {"window", variance(bollinger.window)}};
+    j["atr"] = {{"prev_close", doubleToJson(atr_state.prev_close)}, {"average", exponential(atr_state.average)}};
+    j["obv"] = {{"prev_close", doubleToJson(obv_state.prev_close)}, {"obv", obv_state.obv}};
+    j["vwap"] = {{"price_volume", rolling(vwap_state.price_volume)}, {"volume", rolling(vwap_state.volume)}};
+    j["prev_row"] = {prev_row.ma5, prev_row.ma10, prev_row.ma20, prev_row.k, prev_row.d, prev_row.rsi,
+                     prev_row.macd_line, prev_row.signal_line, prev_row.histogram, prev_row.price_change_percent,
+                     prev_row.code.signal, prev_row.code.strength};
+    return j;
+}
+
+IndicatorState IndicatorState::fromJson(const json &j)
+{
+    if (j.at("version").get<int>() != kStateVersion)
+    {
+        throw std::runtime_error("unsupported indicator state version");
+    }
+
+    SignalConfig config;
+    const json &c = j.at("config");
+    config.price_change_threshold = c.at("price_change_threshold").get<double>();
+    config.ema_fast = c.at("ema_fast").get<int>();
+    config.ema_slow = c.at("ema_slow").get<int>();
+    config.signal_period = c.at("signal_period").get<int>();
+    config.rsi_overbought = c.at("rsi_overbought").get<double>();
+    config.rsi_oversold = c.at("rsi_oversold").get<double>();
+    config.rsi_period = c.at("rsi_period").get<int>();
+    config.rsi_mode = c.at("rsi_mode").get<std::string>() == "wilder" ? RSIMode::Wilder : RSIMode::Simple;
+
+    auto rolling = [](const json &w, RollingSum &out)
+    {
+        std::vector<double> values = doublesFromJson(w.at("values"));
+        if (w.at("period").get<int>() != out.period || static_cast<int>(values.size()) != out.period)
+        {
+            throw std::runtime_error("rolling window period mismatch");
+        }
+        out.count = w.at("count").get<int>();
+        out.head = w.at("head").get<int>();
+        out.invalid = w.at("invalid").get<int>();
+        out.nonzero = w.at("nonzero").get<int>();
+        out.total = w.at("total").get<double>();
+        out.compensation = w.at("compensation").get<double>();
+        out.values = values;
+    };
+    auto monotonic = [](const json &w, MonotonicWindow &out)
+    {
+        std::vector<double> values = doublesFromJson(w.at("values"));
+        std::vector<long long> positions = w.at("positions").get<std::vector<long long>>();
+        if (w.at("period").get<int>() != out.period || static_cast<int>(values.size()) != out.period ||
+            static_cast<int>(positions.size()) != out.period || w.at("kind").get<int>() != static_cast<int>(out.kind))
+        {
+            throw std::runtime_error("monotonic window mismatch");
+        }
+        out.index = w.at("index").get<long long>();
+        out.head = w.at("head").get<int>();
+        out.size = w.at("size").get<int>();
+        out.positions = positions;
+        out.values = values;
+    };
+    auto variance = [](const json &w, RollingVariance &out)
+    {
+        std::vector<double> values = doublesFromJson(w.at("values"));
+        if (w.at("period").get<int>() != out.period || static_cast<int>(values.size()) != out.period)
+        {
+            throw std::runtime_error("rolling variance period mismatch");
+        }
+        out.count = w.at("count").get<int>();
+        out.head = w.at("head").get<int>();
+        out.invalid = w.at("invalid").get<int>();
+        out.valid_count = w.at("valid_count").get<int>();
+        out.average = w.at("average").get<double>();
+        out.m2 = w.at("m2").get<double>();
+        out.values = values;
+    };
+    auto exponential = [](const json &w, ExponentialAverage &out)
+    {
+        if (w.at("period").get<int>() != out.period)
+        {
+            throw std::runtime_error("exponential average period mismatch");
+        }
+        out.seed_count = w.at("seed_count").get<int>();
+        out.seed_sum = w.at("seed_sum").get<double>();
+        out.current = w.at("current").get<double>();
+    };
+
+    IndicatorState state(config, j.at("lookback").get<int>());
+    state.index = j.at("index").get<int>();
+    state.prev_close = j.at("prev_close").get<double>();
+    state.last_date = j.at("last_date").get<std::string>();
+
+    const json &ma = j.at("moving_averages");
+    if (ma.size() != state.moving_averages.windows.size())
+    {
+        throw std::runtime_error("moving average period mismatch");
+    }
+    for (size_t p = 0; p < ma.size(); ++p)
+    {
+        rolling(ma[p], state.moving_averages.windows[p]);
+    }
+
+    const json &kd = j.at("stochastic");
+    state.stochastic.index = kd.at("index").get<int>();
+    monotonic(kd.at("lowest_low"), state.stochastic.lowest_low);
+    monotonic(kd.at("highest_high"), state.stochastic.highest_high);
+    rolling(kd.at("price_flags"), state.stochastic.price_flags);
+    rolling(kd.at("k_window"), state.stochastic.k_window);
+
+    const json &rsi = j.at("rsi");
+    state.rsi_state.index = rsi.at("index").get<int>();
+    state.rsi_state.prev_close = rsi.at("prev_close").get<double>();
+    rolling(rsi.at("gains"), state.rsi_state.gains);
+    rolling(rsi.at("losses"), state.rsi_state.losses);
+    state.rsi_state.wilder_count = rsi.at("wilder_count").get<int>();
+    state.rsi_state.avg_gain = rsi.at("avg_gain").get<double>();
+    state.rsi_state.avg_loss = rsi.at("avg_loss").get<double>();
+
+    const json &macd = j.at("macd");
+    std::vector<double> macd_window = doublesFromJson(macd.at("macd_window"));
+    if (macd_window.size() != state.macd_state.macd_window.size())
+    {
+        throw std::runtime_error("MACD signal window mismatch");
+    }
+    state.macd_state.index = macd.at("index").get<int>();
+    state.macd_state.valid = macd.at("valid").get<bool>();
+    state.macd_state.ema_fast = macd.at("ema_fast").get<double>();
+    state.macd_state.ema_slow = macd.at("ema_slow").get<double>();
+    state.macd_state.macd_window = macd_window;
+    state.macd_state.macd_window_sum = macd.at("macd_window_sum").get<double>();
+    state.macd_state.signal_ema = macd.at("signal_ema").get<double>();
+    state.macd_state.signal_decay = macd.at("signal_decay").get<double>();
+
+    const json &bands = j.at("bollinger");
+    state.bollinger.width = bands.at("width").get<double>();
+    variance(bands.at("window"), state.bollinger.window);
+    const json &atr = j.at("atr");
+    state.atr_state.prev_close = doubleFromJson(atr.at("prev_close"));
+    exponential(atr.at("average"), state.atr_state.average);
+    const json &obv = j.at("obv");
+    state.obv_state.prev_close = doubleFromJson(obv.at("prev_close"));
+    state.obv_state.obv = obv.at("obv").get<double>();
+    const json &vwap = j.at("vwap");
+    rolling(vwap.at("price_volume"), state.vwap_state.price_volume);
+    rolling(vwap.at("volume"), state.vwap_state.volume);
+
+    const json &row = j.at("prev_row");
+    state.prev_row.ma5 = row.at(0).get<double>();
+    state.prev_row.ma10 = row.at(1).get<double>();
+    state.prev_row.ma20 = row.at(2).get<double>();
+    state.prev_row.k = row.at(3).get<double>();
+    state.prev_row.d = row.at(4).get<double>();
+    state.prev_row.rsi = row.at(5).get<double>();
+    state.prev_row.macd_line = row.at(6).get<double>();
+    state.prev_row.signal_line = row.at(7).get<double>();
+    state.prev_row.histogram = row.at(8).get<double>();
+    state.prev_row.price_change_percent = row.at(9).get<double>();
+    state.prev_row.code.signal = static_cast<signed char>(row.at(10).get<int>());
+    state.prev_row.code.strength = static_cast<signed char>(row.at(11).get<int>());
+    return state;
+}
+
+bool IndicatorState::save(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "無法寫入指標狀態檔: " << path << std::endl;
+        return false;
+    }
+    file << toJson().dump();
+    return static_cast<bool>(file);
+}
+
+bool IndicatorState::load(const std::string &path, IndicatorState &state)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    try
+    {
+        json j;
+        file >> j;
+        state = fromJson(j);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "指標狀態檔格式錯誤 (" << path << "): " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef INDICATOR_STATE_H
+#define INDICATOR_STATE_H
+#include <string>
+#include "KLine.h"
+#include "KLineRecord.h"
+#include "Tech_Analysis.h"
+#include "IndicatorPipeline.h"
+#include "json.hpp"
+
+// 單根 K 線的全部指標值
+struct IndicatorRow
+{
+    double ma5 = 0.0, ma10 = 0.0, ma20 = 0.0;
+    double k = 0.0, d = 0.0;
+    double rsi = 0.0;
+    double macd_line = 0.0, signal_line = 0.0, histogram = 0.0;
+    double price_change_percent = 0.0;
+    double bollinger_upper = 0.0, bollinger_lower = 0.0;
+    double atr = 0.0, obv = 0.0, vwap = 0.0;
+    SignalCode code;
+    uint32_t valid = 0; // IndicatorValidity 位元
+};
+
+// 單一股票的指標遞推狀態：保存 EMA、MA/KD/RSI 視窗與前一根 K 線，
+// 新的一根 K 線只需 O(1) 更新即可得到當日所有指標，並可序列化後於下次執行接續
+class IndicatorState
+{
+public:
+    // lookback 之前的 K 線不產生交易訊號
+    IndicatorState(const SignalConfig &config, int lookback);
+
+    IndicatorRow advance(double high, double low, double close, long long volume);
+    KLineRecord update(const std::string &date, const Candle &candle);
+
+    int barCount() const { return index; }
+    const std::string &lastDate() const { return last_date; }
+    // advance() 不帶日期，批次計算後由呼叫端記錄最後一根 K 線的日期
+    void setLastDate(const std::string &date) { last_date = date; }
+    const SignalConfig &getConfig() const { return config; }
+    int getLookback() const { return lookback; }
+
+    nlohmann::json toJson() const;
+    static IndicatorState fromJson(const nlohmann::json &j);
+    bool save(const std::string &path) const;
+    // 讀取失敗或格式不符時回傳 false，state 保持不變
+    static bool load(const std::string &path, IndicatorState &state);
+
+private:
+    SignalConfig config;
+    int lookback;
+    int index; // 已處理的 K 線數
+    double prev_close;
+    std::string last_date;
+    MovingAverageState moving_averages;
+    StochasticState stochastic;
+    RSIState rsi_state;
+    MACDState macd_state;
+    BollingerState bollinger;
+    ATRState atr_state;
+    OBVState obv_state;
+    VWAPState vwap_state;
+    IndicatorRow prev_row; // 訊號評分需要前一根的 MACD 與 KD
+};
+
+#endif
@@ -4,7 +4,7 @@
 
 Candle::Candle() : open(0), high(0), low(0), close(0), volume(0), price_change_percent(0) {}
 
-Candle::Candle(double o, double h, double l, double c, int v, double pcp)
+Candle::Candle(double o, double h, double l, double c, long long v, double pcp)
     : open(o), high(h), low(l), close(c), volume(v), price_change_percent(pcp)
 {
     if (!isValid())
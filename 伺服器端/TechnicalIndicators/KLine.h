@@ -10,7 +10,7 @@ class Candle
 {
 private:
     double open, high, low, close;
-    int volume;
+    long long volume; // 64 位元，避免大型股成交量溢位
     double price_change_percent;
 
     friend class TradingSystem;
@@ -19,7 +19,7 @@ private:
 
 public:
     Candle();
-    Candle(double o, double h, double l, double c, int v, double pcp = 0.0);
+    Candle(double o, double h, double l, double c, long long v, double pcp = 0.0);
     Candle(const Candle &other) = default;
     bool isValid() const;
 
@@ -27,7 +27,7 @@ public:
     double getHigh() const { return high; }
     double getLow() const { return low; }
     double getClose() const { return close; }
-    int getVolume() const { return volume; }
+    long long getVolume() const { return volume; }
     double getPriceChangePercent() const { return price_change_percent; }
     void setPriceChangePercent(double pcp);
 };
@@ -7,6 +7,8 @@ KLineRecord::KLineRecord(
     double k_val, double d_val,
     double r,
     double macd_l, double sig_l, double hist,
+    double boll_u, double boll_l,
+    double atr_val, double obv_val, double vwap_val,
     const std::string &sig,
     const std::string &str)
     : date(d),
@@ -26,6 +28,11 @@ KLineRecord::KLineRecord(
       histogram(hist),
       signal(sig),
       strength(str),
-      price_change_percent(k.getPriceChangePercent())
+      price_change_percent(k.getPriceChangePercent()),
+      bollinger_upper(boll_u),
+      bollinger_lower(boll_l),
+      atr(atr_val),
+      obv(obv_val),
+      vwap(vwap_val)
 {
 }
\ No newline at end of file
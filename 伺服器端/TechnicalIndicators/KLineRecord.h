@@ -15,6 +15,8 @@ public:
     double macd_line, signal_line, histogram;
     std::string signal, strength;
     double price_change_percent;
+    double bollinger_upper, bollinger_lower;
+    double atr, obv, vwap;
 
     KLineRecord(
         const std::string &d,
@@ -23,6 +25,8 @@ public:
         double k_val, double d_val,
         double r,
         double macd_l, double sig_l, double hist,
+        double boll_u, double boll_l,
+        double atr_val, double obv_val, double vwap_val,
         const std::string &sig,
         const std::string &str);
 };
@@ -0,0 +1,80 @@
+#include "ParallelBatch.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+ParallelBatch::ParallelBatch(size_t thread_count, size_t max_in_flight)
+    : thread_count(thread_count), max_in_flight(max_in_flight)
+{
+    if (this->thread_count == 0)
+    {
+        this->thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->max_in_flight == 0)
+    {
+        this->max_in_flight = 2 * this->thread_count;
+    }
+}
+
+void ParallelBatch::run(size_t count, const std::function<void(size_t)> &process,
+                        const std::function<void(size_t)> &emit) const
+{
+    std::vector<char> done(count, 0);
+    size_t next_claim = 0, next_emit = 0;
+    bool emitting = false;
+    std::mutex mutex;
+    std::condition_variable slot_free;
+
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            size_t i;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // 與尚未輸出的最舊工作相距 max_in_flight 以上時等待，避免結果堆積
+                slot_free.wait(lock, [&]
+                               { return next_claim >= count || next_claim < next_emit + max_in_flight; });
+                if (next_claim >= count)
+                {
+                    return;
+                }
+                i = next_claim++;
+            }
+
+            process(i);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done[i] = 1;
+            if (emitting)
+            {
+                continue; // 正在輸出的執行緒會接著處理這筆
+            }
+            emitting = true;
+            while (next_emit < count && done[next_emit])
+            {
+                size_t index = next_emit;
+                lock.unlock();
+                emit(index);
+                lock.lock();
+                ++next_emit;
+                slot_free.notify_all();
+            }
+            emitting = false;
+        }
+    };
+
+    size_t workers = std::min(thread_count, std::max<size_t>(count, 1));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; ++t)
+    {
+        threads.emplace_back(worker);
+    }
+    worker(); // 呼叫端執行緒也參與處理
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef PARALLEL_BATCH_H
+#define PARALLEL_BATCH_H
+#include <cstddef>
+#include <functional>
+
+// 固定數量工作執行緒處理 0..count-1 的批次工作，並依索引順序輸出結果。
+// 已開始但尚未輸出的工作最多 max_in_flight 件，讓記憶體用量不隨批次大小成長
+class ParallelBatch
+{
+public:
+    // thread_count 為 0 時使用硬體執行緒數，max_in_flight 為 0 時使用 2 倍執行緒數
+    explicit ParallelBatch(size_t thread_count = 0, size_t max_in_flight = 0);
+
+    // process(i) 可在多條執行緒上同時執行；emit(i) 於 process(i) 完成後依索引順序呼叫，
+    // 同一時間只有一條執行緒在 emit。所有工作輸出後才返回
+    void run(size_t count, const std::function<void(size_t)> &process,
+             const std::function<void(size_t)> &emit) const;
+
+    size_t getThreadCount() const { return thread_count; }
+    size_t getMaxInFlight() const { return max_in_flight; }
+
+private:
+    size_t thread_count;
+    size_t max_in_flight;
+};
+
+#endif
@@ -0,0 +1,191 @@
+// _processed.json 輸出測試：json DOM + dump（原流程）對照 ProcessedJsonWriter，
+// 比對輸出是否逐位元組相同，並記錄耗時與峰值記憶體
+// 用法: ProcessedJsonBenchmark [資料夾=./json.file] [重複次數=5]
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "DailySeriesReader.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "ProcessedJsonWriter.h"
+#include "TradeSignal.h"
+#include "json.hpp"
+#define SYNTHETIC_CANDLES_COUNT_ALLOCATIONS
+#include "SyntheticCandles.h"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace
+{
+    double finiteOrZero(double value)
+    {
+        return std::isfinite(value) ? value : 0.0;
+    }
+
+    // 原 KLineMain 的輸出方式：逐日建立 json 物件，數值經 stringstream 格式化
+    json buildOutputJson(const json &meta_data, const std::vector<std::string> &dates,
+                         const CandleColumns &columns, const IndicatorColumns &indicators)
+    {
+        json output_json;
+        output_json["Meta Data"] = meta_data;
+        json time_series = json::object();
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(4);
+        auto format = [&ss](double value)
+        {
+            ss.str("");
+            ss << value;
+            return ss.str();
+        };
+
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            double open = columns.open[i], high = columns.high[i], low = columns.low[i], close = columns.close[i];
+            json daily_data = json::object();
+            daily_data["1. open"] = format(open);
+            daily_data["2. high"] = format(high);
+            daily_data["3. low"] = format(low);
+            daily_data["4. close"] = format(close);
+            daily_data["5. volume"] = std::to_string(static_cast<double>(columns.volume[i]));
+            daily_data["6. ma5"] = format(finiteOrZero(indicators.ma5[i]));
+            daily_data["7. ma10"] = format(finiteOrZero(indicators.ma10[i]));
+            daily_data["8. ma20"] = format(finiteOrZero(indicators.ma20[i]));
+            daily_data["9. k"] = format(finiteOrZero(indicators.k[i]));
+            daily_data["10. d"] = format(finiteOrZero(indicators.d[i]));
+            daily_data["11. rsi"] = format(finiteOrZero(indicators.rsi[i]));
+            daily_data["12. macd_line"] = format(finiteOrZero(indicators.macd_line[i]));
+            daily_data["13. signal_line"] = format(finiteOrZero(indicators.signal_line[i]));
+            daily_data["14. histogram"] = format(finiteOrZero(indicators.histogram[i]));
+            daily_data["15. price_change_percent"] = format(finiteOrZero(indicators.price_change_percent[i]));
+            daily_data["16. signal"] = signalText(indicators.signal[i]);
+            daily_data["17. strength"] = strengthText(indicators.strength[i]);
+            daily_data["18. body_size"] = format(std::abs(close - open));
+            daily_data["19. body_type"] = (close > open) ? "Bullish" : (close < open ? "Bearish" : "Doji");
+            daily_data["20. upper_shadow"] = format(high - std::max(open, close));
+            daily_data["21. lower_shadow"] = format(std::min(open, close) - low);
+            daily_data["22. bollinger_upper"] = format(finiteOrZero(indicators.bollinger_upper[i]));
+            daily_data["23. bollinger_lower"] = format(finiteOrZero(indicators.bollinger_lower[i]));
+            daily_data["24. atr"] = format(finiteOrZero(indicators.atr[i]));
+            daily_data["25. obv"] = format(finiteOrZero(indicators.obv[i]));
+            daily_data["26. vwap"] = format(finiteOrZero(indicators.vwap[i]));
+            time_series[(i < dates.size()) ? dates[i] : "Unknown"] = daily_data;
+        }
+        output_json["Time Series (Daily)"] = time_series;
+        return output_json;
+    }
+
+    struct Input
+    {
+        std::string name;
+        DailySeries series;
+        std::vector<std::string> dates;
+        IndicatorColumns indicators;
+    };
+
+    struct Measure
+    {
+        double ms = 0.0;
+        size_t peak = 0; // 相對於開始時的峰值配置量
+    };
+
+    template <class F>
+    Measure measure(F &&f)
+    {
+        Measure m;
+        size_t base = g_allocations.live;
+        g_allocations.peak = g_allocations.live;
+        m.ms = elapsedMs(f);
+        m.peak = g_allocations.peak - base;
+        return m;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string folder = argc > 1 ? argv[1] : "./json.file";
+    int repeat = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    SignalConfig config;
+    std::vector<Input> inputs;
+    for (const auto &entry : fs::directory_iterator(folder))
+    {
+        if (entry.path().extension() != ".json")
+        {
+            continue;
+        }
+        Input input;
+        input.name = entry.path().string();
+        std::ostringstream errors;
+        if (!DailySeriesReader::readFile(input.name, input.series, errors))
+        {
+            continue;
+        }
+        input.dates = input.series.dateStrings();
+        IndicatorPipeline pipeline(config);
+        IndicatorState state(config, config.ema_slow + config.signal_period - 1);
+        pipeline.run(input.series.candles, input.indicators, state);
+        inputs.push_back(std::move(input));
+    }
+    if (inputs.empty())
+    {
+        std::cerr << "找不到 JSON 檔案: " << folder << std::endl;
+        return 1;
+    }
+
+    // 逐檔比對兩種輸出
+    size_t mismatches = 0, bytes = 0;
+    for (const auto &input : inputs)
+    {
+        json document = buildOutputJson(input.series.meta_data, input.dates, input.series.candles, input.indicators);
+        std::string indented, compact;
+        ProcessedJsonWriter(ProcessedJsonWriter::Style::Indented)
+            .writeString(indented, input.series.meta_data, input.dates, input.series.candles, input.indicators);
+        ProcessedJsonWriter(ProcessedJsonWriter::Style::Compact)
+            .writeString(compact, input.series.meta_data, input.dates, input.series.candles, input.indicators);
+        if (indented != document.dump(4) || compact != document.dump())
+        {
+            std::cerr << "輸出不一致: " << input.name << std::endl;
+            ++mismatches;
+        }
+        bytes += indented.size();
+    }
+
+    // 每個檔案都序列化成字串，模擬寫入檔案前的全部工作
+    Measure dom = measure([&]
+                          {
+        for (int r = 0; r < repeat; ++r)
+        {
+            for (const auto &input : inputs)
+            {
+                std::string text = buildOutputJson(input.series.meta_data, input.dates, input.series.candles, input.indicators).dump(4);
+            }
+        } });
+    // 寫入器輸出到容量固定的緩衝區後捨棄，對應寫檔時的記憶體用量
+    Measure streaming = measure([&]
+                                {
+        ProcessedJsonWriter writer;
+        for (int r = 0; r < repeat; ++r)
+        {
+            for (const auto &input : inputs)
+            {
+                writer.writeFile("/dev/null", input.series.meta_data, input.dates, input.series.candles, input.indicators);
+            }
+        } });
+
+    double megabytes = static_cast<double>(bytes) * repeat / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "files=" << inputs.size() << " output_bytes=" << bytes << " repeat=" << repeat
+              << " mismatches=" << mismatches << "\n";
+    std::cout << "dom+dump(4)  " << std::setw(9) << dom.ms << " ms  " << std::setw(8) << megabytes / (dom.ms / 1000.0)
+              << " MB/s  peak=" << dom.peak / 1024 << " KiB\n";
+    std::cout << "writer       " << std::setw(9) << streaming.ms << " ms  " << std::setw(8) << megabytes / (streaming.ms / 1000.0)
+              << " MB/s  peak=" << streaming.peak / 1024 << " KiB  (" << dom.ms / streaming.ms << "x)\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+#include "ProcessedJsonWriter.h"
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include "TradeSignal.h"
+
+namespace
+{
+    const size_t kBufferSize = 1 << 16;
+    const size_t kMaxNumberLength = 352; // 最大有限 double 以固定小數表示所需長度
+
+    double finiteOrZero(double value)
+    {
+        return std::isfinite(value) ? value : 0.0;
+    }
+
+    // 字串字面量連同長度，避免執行期 strlen
+    template <size_t N>
+    constexpr size_t literalLength(const char (&)[N]) { return N - 1; }
+}
+
+#define KEY(text) text, literalLength(text)
+
+ProcessedJsonWriter::ProcessedJsonWriter(Style style)
+    : style(style), buffer(kBufferSize), used(0), file(nullptr), text(nullptr) {}
+
+bool ProcessedJsonWriter::writeFile(const std::string &path, const nlohmann::json &meta_data,
+                                    const std::vector<std::string> &dates,
+                                    const CandleColumns &columns, const IndicatorColumns &indicators)
+{
+    std::ofstream output(path, std::ios::binary);
+    if (!output.is_open())
+    {
+        return false;
+    }
+    file = &output;
+    writeDocument(meta_data, dates, columns, indicators);
+    flush();
+    file = nullptr;
+    output.close();
+    return !output.fail();
+}
+
+void ProcessedJsonWriter::writeString(std::string &out, const nlohmann::json &meta_data,
+                                      const std::vector<std::string> &dates,
+                                      const CandleColumns &columns, const IndicatorColumns &indicators)
+{
+    out.clear();
+    text = &out;
+    writeDocument(meta_data, dates, columns, indicators);
+    flush();
+    text = nullptr;
+}
+
+void ProcessedJsonWriter::writeDocument(const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                                        const CandleColumns &columns, const IndicatorColumns &indicators)
+{
+    bool indented = style == Style::Indented;
+    append("{", 1);
+    append(metaSegment(meta_data));
+
+    append(",", 1);
+    newline(1);
+    append(indented ? "\"Time Series (Daily)\": " : "\"Time Series (Daily)\":", indented ? 23 : 22);
+    if (columns.size() == 0)
+    {
+        append("{}", 2);
+    }
+    else
+    {
+        append("{", 1);
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            newline(2);
+            writeDay(i < dates.size() ? dates[i] : std::string("Unknown"), i, columns, indicators);
+            if (i + 1 < columns.size())
+            {
+                append(",", 1);
+            }
+        }
+        newline(1);
+        append("}", 1);
+    }
+    newline(0);
+    append("}", 1);
+}
+
+bool ProcessedJsonWriter::appendDays(const std::string &path, uint64_t existing_size, const nlohmann::json &old_meta_data,
+                                     const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                                     const CandleColumns &columns, const IndicatorColumns &indicators, uint64_t &new_size)
+{
+    // 最後一日物件的 "}" 加上 Time Series 與整份文件的結尾
+    const std::string closing = style == Style::Indented ? "}\n    }\n}" : "}}}";
+    std::fstream output(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!output.is_open() || existing_size < closing.size())
+    {
+        return false;
+    }
+    std::string tail(closing.size(), '\0');
+    output.seekg(static_cast<std::streamoff>(existing_size - closing.size()));
+    if (!output.read(&tail[0], static_cast<std::streamsize>(tail.size())) || tail != closing || output.peek() != EOF)
+    {
+        return false;
+    }
+    output.clear();
+
+    // Meta Data 緊接在開頭的 "{" 之後，長度相同才能就地覆寫
+    std::string old_meta = metaSegment(old_meta_data), new_meta = metaSegment(meta_data);
+    if (old_meta != new_meta)
+    {
+        if (old_meta.size() != new_meta.size())
+        {
+            return false;
+        }
+        std::string current(old_meta.size(), '\0');
+        output.seekg(1);
+        if (!output.read(&current[0], static_cast<std::streamsize>(current.size())) || current != old_meta)
+        {
+            return false;
+        }
+        output.seekp(1);
+        output.write(new_meta.data(), static_cast<std::streamsize>(new_meta.size()));
+    }
+
+    // 從最後一日物件的 "}" 之後接續寫出
+    output.seekp(static_cast<std::streamoff>(existing_size - closing.size() + 1));
+    file = &output;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        append(",", 1);
+        newline(2);
+        writeDay(i < dates.size() ? dates[i] : std::string("Unknown"), i, columns, indicators);
+    }
+    newline(1);
+    append("}", 1);
+    newline(0);
+    append("}", 1);
+    flush();
+    file = nullptr;
+    new_size = static_cast<uint64_t>(output.tellp());
+    output.close();
+    return !output.fail();
+}
+
+bool ProcessedJsonWriter::truncateDays(const std::string &path, uint64_t size)
+{
+    // 附加時只覆寫了最後一日物件 "}" 之後的結尾，截到該 "}" 再補回結尾
+    const std::string closing = style == Style::Indented ? "}\n    }\n}" : "}}}";
+    std::error_code ec;
+    if (size < closing.size() || std::filesystem::file_size(path, ec) < size || ec)
+    {
+        return false;
+    }
+    std::filesystem::resize_file(path, size - closing.size() + 1, ec);
+    if (ec)
+    {
+        return false;
+    }
+    std::ofstream output(path, std::ios::binary | std::ios::app);
+    output.write(closing.data() + 1, static_cast<std::streamsize>(closing.size() - 1));
+    output.close();
+    return !output.fail();
+}
+
+// Meta Data 只有數個欄位，交給 json 輸出以取得相同的跳脫與縮排，再去掉外層大括號
+std::string ProcessedJsonWriter::metaSegment(const nlohmann::json &meta_data) const
+{
+    bool indented = style == Style::Indented;
+    nlohmann::json meta = nlohmann::json::object();
+    meta["Meta Data"] = meta_data;
+    std::string text = indented ? meta.dump(4) : meta.dump();
+    return text.substr(1, text.size() - 2 - (indented ? 1 : 0));
+}
+
+// 一日的欄位，依 json 物件的字典序輸出："1. open"、"10. d"、…、"19. body_type"、"2. high"、"20. …"
+void ProcessedJsonWriter::writeDay(const std::string &date, size_t i, const CandleColumns &columns,
+                                   const IndicatorColumns &indicators)
+{
+    double open = columns.open[i], high = columns.high[i], low = columns.low[i], close = columns.close[i];
+    append("\"", 1);
+    append(date);
+    append(style == Style::Indented ? "\": {" : "\":{", style == Style::Indented ? 4 : 3);
+
+    std::string signal = signalText(indicators.signal[i]);
+    std::string strength = strengthText(indicators.strength[i]);
+    const char *body_type = (close > open) ? "Bullish" : (close < open ? "Bearish" : "Doji");
+
+    fixed(KEY("1. open"), open, 4, false);
+    fixed(KEY("10. d"), finiteOrZero(indicators.d[i]), 4, false);
+    fixed(KEY("11. rsi"), finiteOrZero(indicators.rsi[i]), 4, false);
+    fixed(KEY("12. macd_line"), finiteOrZero(indicators.macd_line[i]), 4, false);
+    fixed(KEY("13. signal_line"), finiteOrZero(indicators.signal_line[i]), 4, false);
+    fixed(KEY("14. histogram"), finiteOrZero(indicators.histogram[i]), 4, false);
+    fixed(KEY("15. price_change_percent"), finiteOrZero(indicators.price_change_percent[i]), 4, false);
+    field(KEY("16. signal"), signal.data(), signal.size(), false);
+    field(KEY("17. strength"), strength.data(), strength.size(), false);
+    fixed(KEY("18. body_size"), std::abs(close - open), 4, false);
+    field(KEY("19. body_type"), body_type, std::strlen(body_type), false);
+    fixed(KEY("2. high"), high, 4, false);
+    fixed(KEY("20. upper_shadow"), high - std::max(open, close), 4, false);
+    fixed(KEY("21. lower_shadow"), std::min(open, close) - low, 4, false);
+    fixed(KEY("22. bollinger_upper"), finiteOrZero(indicators.bollinger_upper[i]), 4, false);
+    fixed(KEY("23. bollinger_lower"), finiteOrZero(indicators.bollinger_lower[i]), 4, false);
+    fixed(KEY("24. atr"), finiteOrZero(indicators.atr[i]), 4, false);
+    fixed(KEY("25. obv"), finiteOrZero(indicators.obv[i]), 4, false);
+    fixed(KEY("26. vwap"), finiteOrZero(indicators.vwap[i]), 4, false);
+    fixed(KEY("3. low"), low, 4, false);
+    fixed(KEY("4. close"), close, 4, false);
+    fixed(KEY("5. volume"), static_cast<double>(columns.volume[i]), 6, false); // 同 std::to_string(double)
+    fixed(KEY("6. ma5"), finiteOrZero(indicators.ma5[i]), 4, false);
+    fixed(KEY("7. ma10"), finiteOrZero(indicators.ma10[i]), 4, false);
+    fixed(KEY("8. ma20"), finiteOrZero(indicators.ma20[i]), 4, false);
+    fixed(KEY("9. k"), finiteOrZero(indicators.k[i]), 4, true);
+
+    newline(2);
+    append("}", 1);
+}
+
+// 字串欄位；值皆為 ASCII 或 UTF-8 中文，不含需跳脫的字元
+void ProcessedJsonWriter::field(const char *key, size_t key_length, const char *value, size_t value_length, bool last)
+{
+    newline(3);
+    append("\"", 1);
+    append(key, key_length);
+    append(style == Style::Indented ? "\": \"" : "\":\"", style == Style::Indented ? 4 : 3);
+    append(value, value_length);
+    append(last ? "\"" : "\",", last ? 1 : 2);
+}
+
+// 固定小數位數的數值字串，與 std::fixed + setprecision 的輸出相同
+void ProcessedJsonWriter::fixed(const char *key, size_t key_length, double value, int precision, bool last)
+{
+    char number[kMaxNumberLength + 16];
+    auto result = std::to_chars(number, number + sizeof(number), value, std::chars_format::fixed, precision);
+    field(key, key_length, number, static_cast<size_t>(result.ptr - number), last);
+}
+
+void ProcessedJsonWriter::newline(int level)
+{
+    if (style != Style::Indented)
+    {
+        return;
+    }
+    static const char spaces[] = "\n                "; // 換行 + 4 層縮排
+    append(spaces, 1 + 4 * static_cast<size_t>(level));
+}
+
+void ProcessedJsonWriter::append(const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        if (used == buffer.size())
+        {
+            flush();
+        }
+        size_t n = std::min(length, buffer.size() - used);
+        std::memcpy(buffer.data() + used, data, n);
+        used += n;
+        data += n;
+        length -= n;
+    }
+}
+
+void ProcessedJsonWriter::flush()
+{
+    if (used == 0)
+    {
+        return;
+    }
+    if (file)
+    {
+        file->write(buffer.data(), static_cast<std::streamsize>(used));
+    }
+    else if (text)
+    {
+        text->append(buffer.data(), used);
+    }
+    used = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef PROCESSED_JSON_WRITER_H
+#define PROCESSED_JSON_WRITER_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "IndicatorPipeline.h"
+#include "json.hpp"
+
+// 直接把 _processed.json 文件寫入檔案緩衝區，不建立 json DOM。
+// Indented 與 json::dump(4) 逐位元組相同（鍵依字典序），Compact 與 json::dump() 相同
+class ProcessedJsonWriter
+{
+public:
+    enum class Style
+    {
+        Indented,
+        Compact
+    };
+
+    explicit ProcessedJsonWriter(Style style = Style::Indented);
+
+    // 寫入失敗時回傳 false
+    bool writeFile(const std::string &path, const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                   const CandleColumns &columns, const IndicatorColumns &indicators);
+    // 把新的日資料接到 writeFile 產生、目前大小為 existing_size 的檔案之後，不重寫既有內容；
+    // dates 必須晚於檔案中的所有日期。Meta Data 有變動時就地覆寫，輸出長度不同則不修改並回傳 false，
+    // 檔案結尾不符（非同一格式或已被修改）時同樣回傳 false，由呼叫端改為重寫整個檔案
+    bool appendDays(const std::string &path, uint64_t existing_size, const nlohmann::json &old_meta_data,
+                    const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                    const CandleColumns &columns, const IndicatorColumns &indicators, uint64_t &new_size);
+    // 捨棄 appendDays 附加的日資料，把檔案還原為附加前大小為 size 的內容（size 為 writeFile 或 appendDays 之後的大小）
+    bool truncateDays(const std::string &path, uint64_t size);
+    // 寫入字串（主要供比對與測試用）
+    void writeString(std::string &out, const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                     const CandleColumns &columns, const IndicatorColumns &indicators);
+
+private:
+    std::string metaSegment(const nlohmann::json &meta_data) const;
+    void writeDocument(const nlohmann::json &meta_data, const std::vector<std::string> &dates,
+                       const CandleColumns &columns, const IndicatorColumns &indicators);
+    void writeDay(const std::string &date, size_t i, const CandleColumns &columns, const IndicatorColumns &indicators);
+    void field(const char *key, size_t key_length, const char *value, size_t value_length, bool last);
+    void fixed(const char *key, size_t key_length, double value, int precision, bool last);
+    void newline(int level);
+    void append(const char *text, size_t length);
+    void append(const std::string &text) { append(text.data(), text.size()); }
+    void flush();
+
+    Style style;
+    std::vector<char> buffer; // 固定大小，滿了就寫出
+    size_t used;
+    std::ostream *file;       // 為 nullptr 時寫入 text
+    std::string *text;
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "Resampler.h"
+#include <algorithm>
+#include "DailySeriesReader.h"
+
+const char *timeframeName(Timeframe timeframe)
+{
+    switch (timeframe)
+    {
+    case Timeframe::Weekly:
+        return "weekly";
+    case Timeframe::Monthly:
+        return "monthly";
+    default:
+        return "daily";
+    }
+}
+
+int periodKey(int day, Timeframe timeframe)
+{
+    switch (timeframe)
+    {
+    case Timeframe::Weekly:
+    {
+        // 1970-01-01 為星期四，(day + 3) mod 7 == 0 為星期一
+        int weekday = ((day + 3) % 7 + 7) % 7;
+        return day - weekday;
+    }
+    case Timeframe::Monthly:
+    {
+        int year, month, day_of_month;
+        civilFromDayNumber(day, year, month, day_of_month);
+        return year * 12 + month - 1;
+    }
+    default:
+        return day;
+    }
+}
+
+// ---------------- PeriodAggregate ----------------
+
+void PeriodAggregate::start(int key, int day, double open, double high, double low, double close, long long volume)
+{
+    this->key = key;
+    first_day = last_day = day;
+    bars = 1;
+    this->open = open;
+    this->high = high;
+    this->low = low;
+    this->close = close;
+    this->volume = volume;
+}
+
+void PeriodAggregate::add(int day, double high, double low, double close, long long volume)
+{
+    last_day = day;
+    ++bars;
+    this->high = std::max(this->high, high);
+    this->low = std::min(this->low, low);
+    this->close = close;
+    this->volume += volume;
+}
+
+Candle PeriodAggregate::candle() const
+{
+    return Candle(open, high, low, close, volume);
+}
+
+// ---------------- Resampler ----------------
+
+Resampler::Resampler(Timeframe timeframe) : timeframe(timeframe) {}
+
+bool Resampler::push(int day, double open, double high, double low, double close, long long volume, PeriodAggregate &completed)
+{
+    int key = periodKey(day, timeframe);
+    if (partial_period.bars > 0 && key == partial_period.key)
+    {
+        partial_period.add(day, high, low, close, volume);
+        return false;
+    }
+    bool finished = partial_period.bars > 0;
+    if (finished)
+    {
+        completed = partial_period;
+    }
+    partial_period.start(key, day, open, high, low, close, volume);
+    return finished;
+}
+
+// ---------------- TimeframeSeries ----------------
+
+TimeframeSeries TimeframeSeries::rows(size_t begin, size_t end) const
+{
+    TimeframeSeries slice;
+    slice.timeframe = timeframe;
+    slice.last_partial = last_partial && end == days.size();
+    auto copy = [begin, end](const auto &from, auto &to) { to.assign(from.begin() + begin, from.begin() + end); };
+    copy(days, slice.days);
+    copy(candles.open, slice.candles.open);
+    copy(candles.high, slice.candles.high);
+    copy(candles.low, slice.candles.low);
+    copy(candles.close, slice.candles.close);
+    copy(candles.volume, slice.candles.volume);
+    const IndicatorColumns &c = indicators;
+    IndicatorColumns &s = slice.indicators;
+    copy(c.ma5, s.ma5);
+    copy(c.ma10, s.ma10);
+    copy(c.ma20, s.ma20);
+    copy(c.k, s.k);
+    copy(c.d, s.d);
+    copy(c.rsi, s.rsi);
+    copy(c.macd_line, s.macd_line);
+    copy(c.signal_line, s.signal_line);
+    copy(c.histogram, s.histogram);
+    copy(c.price_change_percent, s.price_change_percent);
+    copy(c.bollinger_upper, s.bollinger_upper);
+    copy(c.bollinger_lower, s.bollinger_lower);
+    copy(c.atr, s.atr);
+    copy(c.obv, s.obv);
+    copy(c.vwap, s.vwap);
+    copy(c.signal, s.signal);
+    copy(c.strength, s.strength);
+    copy(c.valid, s.valid);
+    return slice;
+}
+
+// ---------------- MultiTimeframePipeline ----------------
+
+MultiTimeframePipeline::MultiTimeframePipeline(const SignalConfig &config, int lookback, const std::vector<Timeframe> &timeframes)
+{
+    for (Timeframe timeframe : timeframes)
+    {
+        Track track{Resampler(timeframe), IndicatorState(config, lookback), TimeframeSeries()};
+        track.completed.timeframe = timeframe;
+        tracks.push_back(std::move(track));
+    }
+}
+
+void MultiTimeframePipeline::append(TimeframeSeries &series, int day, const Candle &candle, const IndicatorRow &row)
+{
+    series.days.push_back(day);
+    series.candles.push_back(candle);
+    IndicatorColumns &c = series.indicators;
+    c.ma5.push_back(row.ma5);
+    c.ma10.push_back(row.ma10);
+    c.ma20.push_back(row.ma20);
+    c.k.push_back(row.k);
+    c.d.push_back(row.d);
+    c.rsi.push_back(row.rsi);
+    c.macd_line.push_back(row.macd_line);
+    c.signal_line.push_back(row.signal_line);
+    c.histogram.push_back(row.histogram);
+    c.price_change_percent.push_back(row.price_change_percent);
+    c.bollinger_upper.push_back(row.bollinger_upper);
+    c.bollinger_lower.push_back(row.bollinger_lower);
+    c.atr.push_back(row.atr);
+    c.obv.push_back(row.obv);
+    c.vwap.push_back(row.vwap);
+    c.signal.push_back(row.code.signal);
+    c.strength.push_back(row.code.strength);
+    c.valid.push_back(row.valid);
+}
+
+void MultiTimeframePipeline::push(int day, double open, double high, double low, double close, long long volume)
+{
+    for (Track &track : tracks)
+    {
+        if (track.resampler.getTimeframe() == Timeframe::Daily)
+        {
+            // 日 K 線本身即為完整的週期
+            Candle candle(open, high, low, close, volume);
+            append(track.completed, day, candle, track.state.advance(candle.getHigh(), candle.getLow(), candle.getClose(), candle.getVolume()));
+            continue;
+        }
+        PeriodAggregate completed;
+        if (track.resampler.push(day, open, high, low, close, volume, completed))
+        {
+            Candle candle = completed.candle();
+            append(track.completed, completed.last_day, candle,
+                   track.state.advance(candle.getHigh(), candle.getLow(), candle.getClose(), candle.getVolume()));
+        }
+    }
+}
+
+void MultiTimeframePipeline::pushAll(const std::vector<int> &days, const CandleColumns &daily, size_t first)
+{
+    for (size_t i = first; i < daily.size(); ++i)
+    {
+        push(days[i], daily.open[i], daily.high[i], daily.low[i], daily.close[i], daily.volume[i]);
+    }
+}
+
+TimeframeSeries MultiTimeframePipeline::result(Timeframe timeframe) const
+{
+    for (const Track &track : tracks)
+    {
+        if (track.resampler.getTimeframe() != timeframe)
+        {
+            continue;
+        }
+        TimeframeSeries series = track.completed;
+        if (track.resampler.hasPartial())
+        {
+            // 尚未結束的週期：以狀態副本推進一次，不影響之後的計算
+            IndicatorState provisional = track.state;
+            const PeriodAggregate &partial = track.resampler.partial();
+            Candle candle = partial.candle();
+            append(series, partial.last_day, candle, provisional.advance(candle.getHigh(), candle.getLow(), candle.getClose(), candle.getVolume()));
+            series.last_partial = true;
+        }
+        return series;
+    }
+    TimeframeSeries empty;
+    empty.timeframe = timeframe;
+    return empty;
+}
+
+std::vector<TimeframeState> MultiTimeframePipeline::states() const
+{
+    std::vector<TimeframeState> saved;
+    saved.reserve(tracks.size());
+    for (const Track &track : tracks)
+    {
+        saved.push_back(TimeframeState{track.resampler.getTimeframe(), track.state, track.resampler.partial()});
+    }
+    return saved;
+}
+
+bool MultiTimeframePipeline::restore(const std::vector<TimeframeState> &saved)
+{
+    if (saved.size() != tracks.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        if (saved[i].timeframe != tracks[i].resampler.getTimeframe())
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        Track &track = tracks[i];
+        track.state = saved[i].state;
+        track.resampler.restore(saved[i].partial);
+        track.completed = TimeframeSeries();
+        track.completed.timeframe = saved[i].timeframe;
+    }
+    return true;
+}
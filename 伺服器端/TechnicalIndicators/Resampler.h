@@ -0,0 +1,105 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+#include <cstddef>
+#include <vector>
+#include "KLine.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+
+enum class Timeframe
+{
+    Daily,
+    Weekly, // 星期一至星期日
+    Monthly
+};
+
+const char *timeframeName(Timeframe timeframe);
+// 日序所屬週期的鍵：日為日序本身，週為該週星期一的日序，月為 年*12+月-1
+int periodKey(int day, Timeframe timeframe);
+
+// 一個週期的 OHLCV 聚合，新的日 K 線以 O(1) 併入
+struct PeriodAggregate
+{
+    int key = 0;
+    int first_day = 0, last_day = 0; // 週期內第一與最後一個交易日
+    int bars = 0;
+    double open = 0.0, high = 0.0, low = 0.0, close = 0.0;
+    long long volume = 0;
+
+    void start(int key, int day, double open, double high, double low, double close, long long volume);
+    void add(int day, double high, double low, double close, long long volume);
+    Candle candle() const;
+};
+
+// 把日 K 線轉成週 K / 月 K：push 逐日併入並維護尚未結束週期的部分聚合。週期以最後一個交易日標示
+class Resampler
+{
+public:
+    explicit Resampler(Timeframe timeframe);
+
+    // 併入一根日 K 線（日期須遞增）；開始新週期時前一週期結束，寫入 completed 並回傳 true
+    bool push(int day, double open, double high, double low, double close, long long volume, PeriodAggregate &completed);
+    bool hasPartial() const { return partial_period.bars > 0; }
+    const PeriodAggregate &partial() const { return partial_period; }
+    // 從檢查點接回尚未結束的週期
+    void restore(const PeriodAggregate &partial) { partial_period = partial; }
+    Timeframe getTimeframe() const { return timeframe; }
+
+private:
+    Timeframe timeframe;
+    PeriodAggregate partial_period;
+};
+
+// 某一週期的 K 線與指標欄位
+struct TimeframeSeries
+{
+    Timeframe timeframe = Timeframe::Daily;
+    std::vector<int> days; // 各週期最後一個交易日
+    CandleColumns candles;
+    IndicatorColumns indicators;
+    bool last_partial = false; // 最後一列是否為尚未結束的週期（指標為暫算值）
+
+    size_t size() const { return days.size(); }
+    // 第 begin 至 end - 1 列的副本
+    TimeframeSeries rows(size_t begin, size_t end) const;
+};
+
+// 某一週期的遞推狀態：已結束週期推進後的指標狀態，與尚未結束週期的部分聚合
+struct TimeframeState
+{
+    Timeframe timeframe;
+    IndicatorState state;
+    PeriodAggregate partial;
+};
+
+// 單次走訪日 K 線，同時產生多個週期的 K 線與 MACD/KD/RSI 等指標。
+// 已結束的週期依序推進各自的 IndicatorState；尚未結束的週期在 result() 時以狀態副本暫算
+class MultiTimeframePipeline
+{
+public:
+    MultiTimeframePipeline(const SignalConfig &config, int lookback, const std::vector<Timeframe> &timeframes);
+
+    void push(int day, double open, double high, double low, double close, long long volume);
+    // 從第 first 根日 K 線開始併入
+    void pushAll(const std::vector<int> &days, const CandleColumns &daily, size_t first = 0);
+    TimeframeSeries result(Timeframe timeframe) const;
+
+    // 各週期目前的遞推狀態，存入檢查點後下次可只併入新增的日 K 線
+    std::vector<TimeframeState> states() const;
+    // 以檢查點的狀態接續；之後 result() 只含接續後才結束的週期。週期與建構時不符時回傳 false
+    bool restore(const std::vector<TimeframeState> &saved);
+
+private:
+    struct Track
+    {
+        Resampler resampler;
+        IndicatorState state;
+        TimeframeSeries completed; // 只含已結束的週期
+    };
+
+    static void append(TimeframeSeries &series, int day, const Candle &candle, const IndicatorRow &row);
+
+    std::vector<Track> tracks;
+};
+
+#endif
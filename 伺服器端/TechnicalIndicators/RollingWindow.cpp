@@ -0,0 +1,287 @@
+#include "RollingWindow.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+RollingSum::RollingSum(int period)
+    : period(std::max(period, 1)), count(0), head(0), invalid(0), nonzero(0), total(0.0), compensation(0.0),
+      values(std::max(period, 1), 0.0)
+{
+}
+
+void RollingSum::push(double value, bool valid)
+{
+    valid = valid && std::isfinite(value);
+    if (count == period)
+    {
+        double old = values[head];
+        if (std::isnan(old))
+        {
+            invalid--;
+        }
+        else if (old != 0.0)
+        {
+            add(-old);
+            nonzero--;
+        }
+    }
+    else
+    {
+        count++;
+    }
+
+    if (valid)
+    {
+        values[head] = value;
+        if (value != 0.0)
+        {
+            add(value);
+            nonzero++;
+        }
+    }
+    else
+    {
+        values[head] = std::numeric_limits<double>::quiet_NaN();
+        invalid++;
+    }
+    head = (head + 1) % period;
+    if (nonzero == 0)
+    {
+        total = compensation = 0.0;
+    }
+}
+
+void RollingSum::add(double value)
+{
+    double t = total + value;
+    if (std::abs(total) >= std::abs(value))
+    {
+        compensation += (total - t) + value;
+    }
+    else
+    {
+        compensation += (value - t) + total;
+    }
+    total = t;
+}
+
+void RollingSum::reset()
+{
+    count = head = invalid = nonzero = 0;
+    total = compensation = 0.0;
+    std::fill(values.begin(), values.end(), 0.0);
+}
+
+bool RollingSum::lastValid() const
+{
+    return count > 0 && !std::isnan(values[(head + period - 1) % period]);
+}
+
+double RollingSum::sum() const
+{
+    return nonzero == 0 ? 0.0 : total + compensation;
+}
+
+MonotonicWindow::MonotonicWindow(int period, Kind kind)
+    : period(std::max(period, 1)), kind(kind), index(0), head(0), size(0),
+      positions(std::max(period, 1), 0), values(std::max(period, 1), 0.0)
+{
+}
+
+bool MonotonicWindow::dominates(double incoming, double existing) const
+{
+    return kind == Min ? incoming <= existing : incoming >= existing;
+}
+
+void MonotonicWindow::push(double value, bool valid)
+{
+    long long current = index++;
+
+    // 移除已滑出視窗的首端元素
+    if (size > 0 && positions[head] <= current - period)
+    {
+        head = (head + 1) % period;
+        size--;
+    }
+
+    if (!valid || !std::isfinite(value))
+    {
+        return;
+    }
+
+    // 移除尾端被新值支配的元素，維持佇列單調
+    while (size > 0)
+    {
+        int tail = (head + size - 1) % period;
+        if (!dominates(value, values[tail]))
+        {
+            break;
+        }
+        size--;
+    }
+
+    int slot = (head + size) % period;
+    positions[slot] = current;
+    values[slot] = value;
+    size++;
+}
+
+void MonotonicWindow::reset()
+{
+    index = 0;
+    head = size = 0;
+}
+
+double MonotonicWindow::value() const
+{
+    return size == 0 ? std::numeric_limits<double>::quiet_NaN() : values[head];
+}
+
+RollingVariance::RollingVariance(int period)
+    : period(std::max(period, 1)), count(0), head(0), invalid(0), valid_count(0), average(0.0), m2(0.0),
+      values(std::max(period, 1), 0.0)
+{
+}
+
+void RollingVariance::push(double value, bool valid)
+{
+    valid = valid && std::isfinite(value);
+    if (count == period)
+    {
+        double old = values[head];
+        if (std::isnan(old))
+        {
+            invalid--;
+        }
+        else
+        {
+            remove(old);
+        }
+    }
+    else
+    {
+        count++;
+    }
+
+    if (valid)
+    {
+        values[head] = value;
+        add(value);
+    }
+    else
+    {
+        values[head] = std::numeric_limits<double>::quiet_NaN();
+        invalid++;
+    }
+    head = (head + 1) % period;
+    if (head == 0)
+    {
+        resync();
+    }
+}
+
+void RollingVariance::resync()
+{
+    double sum = 0.0;
+    int n = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (!std::isnan(values[i]))
+        {
+            sum += values[i];
+            n++;
+        }
+    }
+    if (n == 0)
+    {
+        average = m2 = 0.0;
+        return;
+    }
+    double mean = sum / n, squares = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (!std::isnan(values[i]))
+        {
+            squares += (values[i] - mean) * (values[i] - mean);
+        }
+    }
+    average = mean;
+    m2 = squares;
+}
+
+void RollingVariance::add(double value)
+{
+    valid_count++;
+    double delta = value - average;
+    average += delta / valid_count;
+    m2 += delta * (value - average);
+}
+
+void RollingVariance::remove(double value)
+{
+    if (valid_count <= 1)
+    {
+        // 視窗清空時歸零，丟棄累積的殘差
+        valid_count = 0;
+        average = m2 = 0.0;
+        return;
+    }
+    double delta = value - average;
+    average -= delta / (valid_count - 1);
+    m2 -= delta * (value - average);
+    valid_count--;
+}
+
+void RollingVariance::reset()
+{
+    count = head = invalid = valid_count = 0;
+    average = m2 = 0.0;
+    std::fill(values.begin(), values.end(), 0.0);
+}
+
+double RollingVariance::variance() const
+{
+    return (valid_count > 0 && m2 > 0.0) ? m2 / valid_count : 0.0;
+}
+
+double RollingVariance::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+ExponentialAverage::ExponentialAverage(int period, Smoothing smoothing)
+    : period(std::max(period, 1)),
+      alpha(smoothing == Wilder ? 1.0 / std::max(period, 1) : 2.0 / (std::max(period, 1) + 1.0)),
+      seed_count(0), seed_sum(0.0), current(0.0)
+{
+}
+
+void ExponentialAverage::push(double value, bool valid)
+{
+    if (!valid || !std::isfinite(value))
+    {
+        reset();
+        return;
+    }
+    if (seed_count < period)
+    {
+        seed_sum += value;
+        if (++seed_count == period)
+        {
+            current = seed_sum / period;
+        }
+        return;
+    }
+    current = value * alpha + current * (1.0 - alpha);
+}
+
+void ExponentialAverage::reset()
+{
+    seed_count = 0;
+    seed_sum = current = 0.0;
+}
+
+double ExponentialAverage::value() const
+{
+    return ready() ? current : std::numeric_limits<double>::quiet_NaN();
+}
@@ -0,0 +1,136 @@
+#ifndef ROLLING_WINDOW_H
+#define ROLLING_WINDOW_H
+#include <vector>
+
+class IndicatorState;
+
+// 固定長度視窗的滾動加總：每次 push 為 O(1)，並追蹤視窗內的無效值數量
+class RollingSum
+{
+public:
+    explicit RollingSum(int period);
+    void push(double value, bool valid = true);
+    void reset();
+
+    double sum() const;
+    double mean() const { return sum() / period; }
+    int getPeriod() const { return period; }
+    bool full() const { return count >= period; }
+    int invalidCount() const { return invalid; }
+    int validCount() const { return count - invalid; }
+    // 最近一次 push 的值是否有效；尚未輸入時回傳 false
+    bool lastValid() const;
+
+private:
+    friend class IndicatorState; // 序列化需要存取內部狀態
+
+    void add(double value);
+
+    int period;
+    int count;   // 已輸入的筆數（上限 period）
+    int head;    // 下一個寫入位置
+    int invalid; // 視窗內無效值數量
+    int nonzero; // 視窗內非零有效值數量，為 0 時 sum() 直接回傳 0，避免加減累積的殘差
+    double total;
+    double compensation; // Neumaier 補償項，抵銷長序列滾動加減的捨入誤差
+    std::vector<double> values; // 無效值以 NaN 表示
+};
+
+// 固定長度視窗的單調佇列：以環狀緩衝區實作，O(1) 攤銷取得視窗內最小值或最大值
+class MonotonicWindow
+{
+public:
+    enum Kind
+    {
+        Min,
+        Max
+    };
+
+    MonotonicWindow(int period, Kind kind);
+    // 無效值只推進視窗位置，不參與極值比較
+    void push(double value, bool valid = true);
+    void reset();
+
+    // 視窗內沒有有效值時回傳 NaN
+    double value() const;
+    bool empty() const { return size == 0; }
+
+private:
+    friend class IndicatorState;
+
+    bool dominates(double incoming, double existing) const;
+
+    int period;
+    Kind kind;
+    long long index; // 下一筆資料的序號
+    int head;        // 佇列首端在環狀緩衝區中的位置
+    int size;
+    std::vector<long long> positions; // 佇列內各元素的序號
+    std::vector<double> values;
+};
+
+// 固定長度視窗的滾動平均與母體變異數：以 Welford 公式在 O(1) 內加入新值、移除滑出的舊值，
+// 不需每次重掃視窗，也避免平方和相減的抵銷誤差。無效值只佔視窗位置，不參與統計
+class RollingVariance
+{
+public:
+    explicit RollingVariance(int period);
+    void push(double value, bool valid = true);
+    void reset();
+
+    double mean() const { return valid_count > 0 ? average : 0.0; }
+    double variance() const;
+    double stddev() const;
+    int getPeriod() const { return period; }
+    bool full() const { return count >= period; }
+    int invalidCount() const { return invalid; }
+
+private:
+    friend class IndicatorState;
+
+    void add(double value);
+    void remove(double value);
+    // 每填滿一輪視窗以兩趟公式重算一次，攤銷後仍為 O(1)，避免長序列加減累積誤差
+    void resync();
+
+    int period;
+    int count;       // 已輸入的筆數（上限 period）
+    int head;        // 下一個寫入位置
+    int invalid;     // 視窗內無效值數量
+    int valid_count; // 參與統計的有效值數量
+    double average;
+    double m2; // 與平均值差的平方和
+    std::vector<double> values; // 無效值以 NaN 表示
+};
+
+// 以前 period 筆的簡單平均為種子的指數移動平均，之後每筆 O(1) 遞推。
+// Standard 的平滑係數為 2/(period+1)，Wilder 為 1/period；遇到無效值時重新累積種子
+class ExponentialAverage
+{
+public:
+    enum Smoothing
+    {
+        Standard,
+        Wilder
+    };
+
+    explicit ExponentialAverage(int period, Smoothing smoothing = Standard);
+    void push(double value, bool valid = true);
+    void reset();
+
+    // 種子累積完成前回傳 NaN
+    double value() const;
+    bool ready() const { return seed_count >= period; }
+    int getPeriod() const { return period; }
+
+private:
+    friend class IndicatorState;
+
+    int period;
+    double alpha;
+    int seed_count; // 自上次重置以來的有效筆數（上限 period）
+    double seed_sum;
+    double current;
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include "Screener.h"
+#include <cmath>
+
+// ---------------- SymbolBitmap ----------------
+
+SymbolBitmap::SymbolBitmap(size_t size, bool value)
+    : bits(size), words((size + 63) / 64, value ? ~uint64_t(0) : 0)
+{
+    clearTail();
+}
+
+void SymbolBitmap::clearTail()
+{
+    if (bits % 64 != 0)
+    {
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+}
+
+void SymbolBitmap::resize(size_t size)
+{
+    bits = size;
+    words.resize((size + 63) / 64, 0);
+    clearTail();
+}
+
+void SymbolBitmap::set(size_t i, bool value)
+{
+    uint64_t mask = uint64_t(1) << (i % 64);
+    words[i / 64] = value ? (words[i / 64] | mask) : (words[i / 64] & ~mask);
+}
+
+size_t SymbolBitmap::count() const
+{
+    size_t total = 0;
+    for (uint64_t word : words)
+    {
+        total += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+std::vector<size_t> SymbolBitmap::indices() const
+{
+    std::vector<size_t> result;
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+        for (uint64_t word = words[w]; word != 0; word &= word - 1)
+        {
+            result.push_back(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+        }
+    }
+    return result;
+}
+
+SymbolBitmap &SymbolBitmap::operator&=(const SymbolBitmap &other)
+{
+    for (size_t w = 0; w < words.size() && w < other.words.size(); ++w)
+    {
+        words[w] &= other.words[w];
+    }
+    return *this;
+}
+
+SymbolBitmap &SymbolBitmap::operator|=(const SymbolBitmap &other)
+{
+    for (size_t w = 0; w < words.size() && w < other.words.size(); ++w)
+    {
+        words[w] |= other.words[w];
+    }
+    return *this;
+}
+
+SymbolBitmap SymbolBitmap::operator~() const
+{
+    SymbolBitmap result(*this);
+    for (uint64_t &word : result.words)
+    {
+        word = ~word;
+    }
+    result.clearTail();
+    return result;
+}
+
+// ---------------- ScreenerUniverse ----------------
+
+ScreenerUniverse::ScreenerUniverse(size_t depth)
+    : depth(depth == 0 ? 1 : depth),
+      values(static_cast<size_t>(ColumnId::Count) * this->depth),
+      valid(static_cast<size_t>(ColumnId::Count) * this->depth)
+{
+}
+
+size_t ScreenerUniverse::append(const std::string &symbol)
+{
+    size_t index = symbols.size();
+    symbols.push_back(symbol);
+    for (size_t s = 0; s < values.size(); ++s)
+    {
+        values[s].push_back(0.0);
+        valid[s].resize(index + 1);
+    }
+    return index;
+}
+
+size_t ScreenerUniverse::add(const std::string &symbol, const std::vector<int> &days, const CandleColumns &candles,
+                             const IndicatorColumns &indicators)
+{
+    size_t index = append(symbol);
+    size_t rows = candles.size();
+    for (uint32_t c = 0; c < static_cast<uint32_t>(ColumnId::Count); ++c)
+    {
+        ColumnId id = static_cast<ColumnId>(c);
+        for (size_t lag = 0; lag < depth && lag < rows; ++lag)
+        {
+            size_t row = rows - 1 - lag;
+            double value;
+            if (const std::vector<double> *column = indicatorColumn(id, indicators))
+            {
+                value = (*column)[row];
+            }
+            else
+            {
+                switch (id)
+                {
+                case ColumnId::Date: value = days[row]; break;
+                case ColumnId::Open: value = candles.open[row]; break;
+                case ColumnId::High: value = candles.high[row]; break;
+                case ColumnId::Low: value = candles.low[row]; break;
+                case ColumnId::Close: value = candles.close[row]; break;
+                case ColumnId::Volume: value = static_cast<double>(candles.volume[row]); break;
+                case ColumnId::Signal: value = indicators.signal[row]; break;
+                case ColumnId::Strength: value = indicators.strength[row]; break;
+                default: value = 0.0; break;
+                }
+            }
+            bool ok = columnValid(id, row, candles, indicators);
+            values[slot(id, lag)][index] = ok ? value : 0.0;
+            valid[slot(id, lag)].set(index, ok);
+        }
+    }
+    return index;
+}
+
+bool ScreenerUniverse::addFile(const std::string &path, std::ostream &errors)
+{
+    ColumnarFile file;
+    if (!file.open(path, errors))
+    {
+        return false;
+    }
+    size_t index = append(file.symbol());
+    size_t rows = file.rows();
+    for (uint32_t c = 0; c < static_cast<uint32_t>(ColumnId::Count); ++c)
+    {
+        ColumnId id = static_cast<ColumnId>(c);
+        if (!file.hasColumn(id))
+        {
+            continue;
+        }
+        // 開高低收可能以定點儲存，由 prices() 換回浮點
+        PriceView prices = file.prices(id);
+        for (size_t lag = 0; lag < depth && lag < rows; ++lag)
+        {
+            size_t row = rows - 1 - lag;
+            double value = 0.0;
+            bool ok = false;
+            if (!prices.empty())
+            {
+                ok = prices.valid(row);
+                value = ok ? prices[row] : 0.0;
+            }
+            else
+            {
+                switch (file.storedType(id))
+                {
+                case ColumnType::Int8:
+                {
+                    ColumnView<int8_t> view = file.column<int8_t>(id);
+                    ok = !view.empty() && view.valid(row);
+                    value = ok ? view[row] : 0;
+                    break;
+                }
+                case ColumnType::Int32:
+                {
+                    ColumnView<int32_t> view = file.column<int32_t>(id);
+                    ok = !view.empty() && view.valid(row);
+                    value = ok ? view[row] : 0;
+                    break;
+                }
+                case ColumnType::Int64:
+                {
+                    ColumnView<int64_t> view = file.column<int64_t>(id);
+                    ok = !view.empty() && view.valid(row);
+                    value = ok ? static_cast<double>(view[row]) : 0.0;
+                    break;
+                }
+                case ColumnType::Float64:
+                {
+                    ColumnView<double> view = file.column<double>(id);
+                    ok = !view.empty() && view.valid(row);
+                    value = ok ? view[row] : 0.0;
+                    break;
+                }
+                }
+            }
+            values[slot(id, lag)][index] = value;
+            valid[slot(id, lag)].set(index, ok);
+        }
+    }
+    return true;
+}
+
+bool ScreenerUniverse::parseColumn(const std::string &name, ColumnId &id)
+{
+    for (uint32_t c = 0; c < static_cast<uint32_t>(ColumnId::Count); ++c)
+    {
+        if (name == columnName(static_cast<ColumnId>(c)))
+        {
+            id = static_cast<ColumnId>(c);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------- Screener ----------------
+
+namespace
+{
+    // 每 64 檔組成一個字組：比較結果逐位元寫入，迴圈內沒有分支，可由編譯器向量化
+    template <class Op>
+    void scanWords(size_t n, uint64_t *words, Op op)
+    {
+        size_t full = n / 64;
+        for (size_t w = 0; w < full; ++w)
+        {
+            uint64_t word = 0;
+            size_t base = w * 64;
+            for (size_t j = 0; j < 64; ++j)
+            {
+                word |= static_cast<uint64_t>(op(base + j)) << j;
+            }
+            words[w] = word;
+        }
+        if (n % 64 != 0)
+        {
+            uint64_t word = 0;
+            for (size_t j = 0; j < n % 64; ++j)
+            {
+                word |= static_cast<uint64_t>(op(full * 64 + j)) << j;
+            }
+            words[full] = word;
+        }
+    }
+
+    template <class Right>
+    void scanCompare(size_t n, uint64_t *words, const double *a, Compare op, Right b)
+    {
+        switch (op)
+        {
+        case Compare::Less:
+            scanWords(n, words, [&](size_t i) { return a[i] < b(i); });
+            break;
+        case Compare::LessEqual:
+            scanWords(n, words, [&](size_t i) { return a[i] <= b(i); });
+            break;
+        case Compare::Greater:
+            scanWords(n, words, [&](size_t i) { return a[i] > b(i); });
+            break;
+        case Compare::GreaterEqual:
+            scanWords(n, words, [&](size_t i) { return a[i] >= b(i); });
+            break;
+        case Compare::Equal:
+            scanWords(n, words, [&](size_t i) { return a[i] == b(i); });
+            break;
+        case Compare::NotEqual:
+            scanWords(n, words, [&](size_t i) { return a[i] != b(i); });
+            break;
+        }
+    }
+}
+
+Screener::Screener(const ScreenerUniverse &universe) : universe(universe) {}
+
+SymbolBitmap Screener::compare(ColumnId id, Compare op, double value, size_t lag) const
+{
+    SymbolBitmap result(universe.size());
+    if (lag >= universe.getDepth())
+    {
+        return result;
+    }
+    scanCompare(universe.size(), result.data(), universe.column(id, lag), op, [value](size_t) { return value; });
+    return result &= universe.validity(id, lag);
+}
+
+SymbolBitmap Screener::compare(ColumnId a, Compare op, ColumnId b, size_t lag_a, size_t lag_b) const
+{
+    SymbolBitmap result(universe.size());
+    if (lag_a >= universe.getDepth() || lag_b >= universe.getDepth())
+    {
+        return result;
+    }
+    const double *right = universe.column(b, lag_b);
+    scanCompare(universe.size(), result.data(), universe.column(a, lag_a), op, [right](size_t i) { return right[i]; });
+    return result &= universe.validity(a, lag_a) & universe.validity(b, lag_b);
+}
+
+SymbolBitmap Screener::crossAbove(ColumnId a, ColumnId b) const
+{
+    return compare(a, Compare::LessEqual, b, 1, 1) & compare(a, Compare::Greater, b, 0, 0);
+}
+
+SymbolBitmap Screener::crossBelow(ColumnId a, ColumnId b) const
+{
+    return compare(a, Compare::GreaterEqual, b, 1, 1) & compare(a, Compare::Less, b, 0, 0);
+}
+
+std::vector<std::string> Screener::symbols(const SymbolBitmap &bitmap) const
+{
+    std::vector<std::string> result;
+    for (size_t i : bitmap.indices())
+    {
+        result.push_back(universe.symbol(i));
+    }
+    return result;
+}
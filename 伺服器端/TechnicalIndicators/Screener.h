@@ -0,0 +1,105 @@
+#ifndef SCREENER_H
+#define SCREENER_H
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ColumnarFile.h"
+
+// 股票集合的位元圖：第 s 檔符合條件時 bit s 為 1，超出 size() 的位元恆為 0
+class SymbolBitmap
+{
+public:
+    explicit SymbolBitmap(size_t size = 0, bool value = false);
+
+    size_t size() const { return bits; }
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1u; }
+    void set(size_t i, bool value = true);
+    // 新增的位元為 0
+    void resize(size_t size);
+    size_t count() const;
+    std::vector<size_t> indices() const;
+
+    SymbolBitmap &operator&=(const SymbolBitmap &other);
+    SymbolBitmap &operator|=(const SymbolBitmap &other);
+    SymbolBitmap operator&(const SymbolBitmap &other) const { return SymbolBitmap(*this) &= other; }
+    SymbolBitmap operator|(const SymbolBitmap &other) const { return SymbolBitmap(*this) |= other; }
+    SymbolBitmap operator~() const;
+
+    uint64_t *data() { return words.data(); }
+    const uint64_t *data() const { return words.data(); }
+    size_t wordCount() const { return words.size(); }
+
+private:
+    void clearTail();
+
+    size_t bits;
+    std::vector<uint64_t> words;
+};
+
+// 全市場最近 depth 天的欄位快照。每個 (欄位, 倒數第 lag 天) 為一條以股票為索引的連續 double 陣列，
+// 篩選時依欄位線性掃描；lag 0 為各股最新一天
+class ScreenerUniverse
+{
+public:
+    explicit ScreenerUniverse(size_t depth = 2);
+
+    // 加入一檔股票，回傳其索引；不足 depth 天的位置與 columnValid 判定無效的值標為無效
+    size_t add(const std::string &symbol, const std::vector<int> &days, const CandleColumns &candles,
+               const IndicatorColumns &indicators);
+    // 從 .kcol 檔加入一檔股票，沿用檔案的有效位元圖
+    bool addFile(const std::string &path, std::ostream &errors);
+
+    size_t size() const { return symbols.size(); }
+    size_t getDepth() const { return depth; }
+    const std::string &symbol(size_t i) const { return symbols[i]; }
+    const double *column(ColumnId id, size_t lag = 0) const { return values[slot(id, lag)].data(); }
+    const SymbolBitmap &validity(ColumnId id, size_t lag = 0) const { return valid[slot(id, lag)]; }
+
+    // 欄位名稱同 columnName()，找不到時回傳 false
+    static bool parseColumn(const std::string &name, ColumnId &id);
+
+private:
+    size_t slot(ColumnId id, size_t lag) const { return static_cast<size_t>(id) * depth + lag; }
+    size_t append(const std::string &symbol);
+
+    size_t depth;
+    std::vector<std::string> symbols;
+    std::vector<std::vector<double>> values; // [欄位 * depth + lag][股票]
+    std::vector<SymbolBitmap> valid;
+};
+
+enum class Compare
+{
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual
+};
+
+// 橫斷面篩選：每個條件對整條欄位掃描一次，產生位元圖，再以 & | ~ 組合。
+// 任一運算元無效的股票不符合條件
+class Screener
+{
+public:
+    explicit Screener(const ScreenerUniverse &universe);
+
+    // column(id, lag) op value
+    SymbolBitmap compare(ColumnId id, Compare op, double value, size_t lag = 0) const;
+    // column(a, lag_a) op column(b, lag_b)
+    SymbolBitmap compare(ColumnId a, Compare op, ColumnId b, size_t lag_a = 0, size_t lag_b = 0) const;
+    // 最新一天 a 由下往上穿越 b：前一天 a <= b 且當天 a > b
+    SymbolBitmap crossAbove(ColumnId a, ColumnId b) const;
+    // 最新一天 a 由上往下穿越 b：前一天 a >= b 且當天 a < b
+    SymbolBitmap crossBelow(ColumnId a, ColumnId b) const;
+
+    std::vector<std::string> symbols(const SymbolBitmap &bitmap) const;
+
+private:
+    const ScreenerUniverse &universe;
+};
+
+#endif
@@ -0,0 +1,153 @@
+// 橫斷面篩選的效能測試：「RSI < 30 且 MACD 今日黃金交叉」或「收盤突破布林上軌」，
+// 與逐檔以欄位名稱字串取值的寫法比對結果與耗時。給定 .kcol 資料夾時改為篩選實際檔案
+// 用法：ScreenerBenchmark [股票數=5000] [天數=300]
+//       ScreenerBenchmark --dir <.kcol 資料夾>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include "Screener.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "SyntheticCandles.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct Symbol
+    {
+        std::vector<int> days;
+        CandleColumns candles;
+        IndicatorColumns indicators;
+    };
+
+    // 幾何布朗運動產生的模擬 K 線與指標
+    std::vector<Symbol> generateSymbols(size_t symbols, size_t steps, const SignalConfig &config, int lookback)
+    {
+        SyntheticCandles generator(20240601, 0.025);
+        IndicatorPipeline pipeline(config);
+        std::vector<Symbol> result(symbols);
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            Symbol &symbol = result[s];
+            symbol.candles.reserve(steps);
+            generator.reset(SyntheticCandles::startPrice(s));
+            for (size_t t = 0; t < steps; ++t)
+            {
+                SyntheticCandle c = generator.next();
+                symbol.candles.push_back(Candle(c.open, c.high, c.low, c.close, c.volume));
+                symbol.days.push_back(static_cast<int>(18000 + t));
+            }
+            pipeline.run(symbol.candles, symbol.indicators, lookback);
+        }
+        return result;
+    }
+
+    // 直觀寫法：每次取值都以欄位名稱字串比對，同 KLineMain.h 的 getValue
+    double getValue(const Symbol &symbol, size_t index, const std::string &field)
+    {
+        if (field == "close")
+            return symbol.candles.close[index];
+        if (field == "rsi")
+            return symbol.indicators.rsi[index];
+        if (field == "macd_line")
+            return symbol.indicators.macd_line[index];
+        if (field == "signal_line")
+            return symbol.indicators.signal_line[index];
+        if (field == "bollinger_upper")
+            return symbol.indicators.bollinger_upper[index];
+        return 0.0;
+    }
+
+    std::vector<size_t> naiveScreen(const std::vector<Symbol> &symbols)
+    {
+        std::vector<size_t> matches;
+        for (size_t s = 0; s < symbols.size(); ++s)
+        {
+            const Symbol &symbol = symbols[s];
+            size_t last = symbol.candles.size() - 1;
+            bool oversold = getValue(symbol, last, "rsi") < 30.0;
+            bool crossed = getValue(symbol, last - 1, "macd_line") <= getValue(symbol, last - 1, "signal_line") &&
+                           getValue(symbol, last, "macd_line") > getValue(symbol, last, "signal_line");
+            bool breakout = getValue(symbol, last, "close") > getValue(symbol, last, "bollinger_upper");
+            if ((oversold && crossed) || breakout)
+            {
+                matches.push_back(s);
+            }
+        }
+        return matches;
+    }
+
+    SymbolBitmap screen(const Screener &screener)
+    {
+        SymbolBitmap oversold = screener.compare(ColumnId::RSI, Compare::Less, 30.0);
+        SymbolBitmap crossed = screener.crossAbove(ColumnId::MACDLine, ColumnId::SignalLine);
+        SymbolBitmap breakout = screener.compare(ColumnId::Close, Compare::Greater, ColumnId::BollingerUpper);
+        return (oversold & crossed) | breakout;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2 && std::strcmp(argv[1], "--dir") == 0)
+    {
+        ScreenerUniverse universe;
+        for (const auto &entry : fs::directory_iterator(argv[2]))
+        {
+            if (entry.path().extension() == ".kcol")
+            {
+                universe.addFile(entry.path().string(), std::cerr);
+            }
+        }
+        Screener screener(universe);
+        SymbolBitmap result;
+        double us = 1000.0 * timeBestMs([&]
+                                        { result = screen(screener); }, 100);
+        std::cout << "股票數 " << universe.size() << "，符合 " << result.count() << " 檔（" << std::fixed
+                  << std::setprecision(2) << us << " us）:";
+        for (const std::string &symbol : screener.symbols(result))
+        {
+            std::cout << " " << symbol;
+        }
+        std::cout << std::endl;
+        return 0;
+    }
+
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    size_t steps = argc > 2 ? std::max<size_t>(std::strtoul(argv[2], nullptr, 10), 60) : 300;
+    SignalConfig config;
+    config.price_change_threshold = 0.005;
+    config.rsi_period = 14;
+    const int lookback = config.ema_slow + config.signal_period - 1;
+    std::vector<Symbol> symbols = generateSymbols(count, steps, config, lookback);
+
+    ScreenerUniverse universe(2);
+    double load_ms = elapsedMs([&]
+                               {
+        for (size_t s = 0; s < symbols.size(); ++s)
+        {
+            universe.add("S" + std::to_string(s), symbols[s].days, symbols[s].candles, symbols[s].indicators);
+        } });
+
+    Screener screener(universe);
+    SymbolBitmap result;
+    std::vector<size_t> expected;
+    double naive_us = 1000.0 * timeBestMs([&]
+                                          { expected = naiveScreen(symbols); }, 20);
+    double screen_us = 1000.0 * timeBestMs([&]
+                                           { result = screen(screener); }, 200);
+    bool same = result.indices() == expected;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "股票數 " << count << "，每檔 " << steps << " 根 K 線，快照建立 " << load_ms << " ms\n"
+              << "逐檔字串取值: " << naive_us << " us\n"
+              << "欄位掃描+位元圖: " << screen_us << " us（" << naive_us / screen_us << " 倍）\n"
+              << "符合 " << result.count() << " 檔，" << (same ? "結果一致" : "結果不一致") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+#include "SignalSweep.h"
+#include <algorithm>
+#include <cmath>
+#include "ParallelBatch.h"
+
+// ---------------- SweepCache ----------------
+
+SweepCache::SweepCache(const CandleColumns &candles) : candles(candles), invalid_from(static_cast<int>(candles.size()))
+{
+    size_t n = candles.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!std::isfinite(candles.close[i]) || candles.close[i] <= 0)
+        {
+            invalid_from = static_cast<int>(i);
+            break;
+        }
+    }
+    kd.reserve(n);
+    StochasticState stochastic(9, 3);
+    for (size_t i = 0; i < n; ++i)
+    {
+        kd.push_back(stochastic.update(candles.high[i], candles.low[i], candles.close[i]));
+    }
+}
+
+void SweepCache::prepare(const std::vector<SignalConfig> &configs)
+{
+    const std::vector<double> &close = candles.close;
+    for (const SignalConfig &config : configs)
+    {
+        for (int period : {config.ema_fast, config.ema_slow})
+        {
+            if (emas.count(period))
+            {
+                continue;
+            }
+            // 與 MACDState 相同的運算順序，結果逐位元一致
+            std::vector<double> &ema = emas[period];
+            ema.assign(close.size(), 0.0);
+            double k = 2.0 / (period + 1.0);
+            double value = 0.0;
+            for (int i = 0; i < invalid_from; ++i)
+            {
+                if (i < period)
+                {
+                    value += close[i];
+                    if (i == period - 1)
+                    {
+                        value /= period;
+                    }
+                }
+                else
+                {
+                    value = close[i] * k + value * (1.0 - k);
+                }
+                ema[i] = i >= period - 1 ? value : 0.0;
+            }
+        }
+
+        std::pair<int, RSIMode> key(config.rsi_period, config.rsi_mode);
+        if (!rsis.count(key))
+        {
+            std::vector<double> &rsi = rsis[key];
+            rsi.reserve(close.size());
+            RSIState state(config.rsi_period, config.rsi_mode);
+            for (double value : close)
+            {
+                rsi.push_back(state.update(value));
+            }
+        }
+    }
+}
+
+void SweepCache::signals(const SignalConfig &config, int lookback, signed char *signal, signed char *strength) const
+{
+    const std::vector<double> &fast_ema = emas.at(config.ema_fast);
+    const std::vector<double> &slow_ema = emas.at(config.ema_slow);
+    const std::vector<double> &rsi = rsis.at(std::make_pair(config.rsi_period, config.rsi_mode));
+    const int n = static_cast<int>(candles.size());
+    const int slow_period = config.ema_slow, signal_period = config.signal_period;
+    const double k_signal = 2.0 / (signal_period + 1.0);
+
+    // 訊號線以 signalLineStep 遞推（同 MACDState）；視窗最多 signal_period 筆，週期不大時放在堆疊上
+    std::vector<double> window_storage;
+    double small_window[64];
+    int window_size = std::max(signal_period, 1);
+    double *window = small_window;
+    if (window_size > 64)
+    {
+        window_storage.assign(window_size, 0.0);
+        window = window_storage.data();
+    }
+    std::fill(window, window + window_size, 0.0);
+    double window_sum = 0.0, signal_ema = 0.0, signal_decay = 1.0;
+    bool valid = true;
+
+    MACDResult macd(0, 0, 0), macd_prev(0, 0, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        macd = MACDResult(0, 0, 0);
+        if (valid && i >= invalid_from)
+        {
+            valid = false;
+        }
+        if (valid && i >= slow_period - 1)
+        {
+            double fast = (i >= config.ema_fast - 1) ? fast_ema[i] : 0.0;
+            double macd_line = fast - slow_ema[i];
+            if (!std::isfinite(macd_line))
+            {
+                valid = false;
+            }
+            else
+            {
+                double signal_line = signalLineStep(macd_line, i - (slow_period - 1), signal_period, k_signal, window,
+                                                    window_size, window_sum, signal_ema, signal_decay);
+                double histogram = macd_line - signal_line;
+                if (!std::isfinite(signal_line) || !std::isfinite(histogram))
+                {
+                    valid = false;
+                }
+                else
+                {
+                    macd = MACDResult(macd_line, signal_line, histogram);
+                }
+            }
+        }
+
+        SignalCode code;
+        if (i >= lookback)
+        {
+            bool first = i == 0;
+            code = scoreSignal(i, config, macd, first ? macd : macd_prev,
+                               kd[i], first ? kd[i] : kd[i - 1], rsi[i]);
+        }
+        signal[i] = code.signal;
+        strength[i] = code.strength;
+        macd_prev = macd;
+    }
+}
+
+// ---------------- SignalSweep ----------------
+
+SignalSweep::SignalSweep(const BacktestConfig &backtest, SweepMetric metric) : backtester(backtest), metric(metric) {}
+
+std::vector<SignalConfig> SignalSweep::grid(const SignalConfig &base,
+                                            const std::vector<int> &ema_fast,
+                                            const std::vector<int> &ema_slow,
+                                            const std::vector<int> &signal_period,
+                                            const std::vector<double> &rsi_overbought,
+                                            const std::vector<double> &rsi_oversold)
+{
+    std::vector<SignalConfig> configs;
+    for (int fast : ema_fast)
+    {
+        for (int slow : ema_slow)
+        {
+            for (int signal : signal_period)
+            {
+                for (double overbought : rsi_overbought)
+                {
+                    for (double oversold : rsi_oversold)
+                    {
+                        if (fast <= 0 || signal <= 0 || fast >= slow || oversold >= overbought)
+                        {
+                            continue;
+                        }
+                        SignalConfig config = base;
+                        config.ema_fast = fast;
+                        config.ema_slow = slow;
+                        config.signal_period = signal;
+                        config.rsi_overbought = overbought;
+                        config.rsi_oversold = oversold;
+                        configs.push_back(config);
+                    }
+                }
+            }
+        }
+    }
+    return configs;
+}
+
+double SignalSweep::scoreOf(const SweepResult &result) const
+{
+    switch (metric)
+    {
+    case SweepMetric::TotalReturn:
+        return result.mean_total_return;
+    case SweepMetric::AnnualizedReturn:
+        return result.mean_annualized_return;
+    case SweepMetric::HitRate:
+        return result.hit_rate;
+    case SweepMetric::Calmar:
+        return result.mean_max_drawdown > 0.0 ? result.mean_annualized_return / result.mean_max_drawdown : 0.0;
+    default:
+        return result.mean_sharpe;
+    }
+}
+
+std::vector<SweepResult> SignalSweep::run(const std::vector<CandleColumns> &symbols, const std::vector<SignalConfig> &configs,
+                                          const ParallelBatch &batch) const
+{
+    std::vector<SweepResult> results(configs.size());
+    for (size_t c = 0; c < configs.size(); ++c)
+    {
+        results[c].config = configs[c];
+    }
+    if (symbols.empty())
+    {
+        return results;
+    }
+
+    // 逐檔建立快取，各設定的訊號與回測分散到執行緒；同一設定的彙總只由負責它的執行緒寫入
+    for (const CandleColumns &candles : symbols)
+    {
+        SweepCache cache(candles);
+        cache.prepare(configs);
+        batch.run(
+            configs.size(),
+            [&](size_t c)
+            {
+                std::vector<signed char> signal(candles.size()), strength(candles.size());
+                cache.signals(configs[c], lookbackOf(configs[c]), signal.data(), strength.data());
+                BacktestSeries series;
+                series.close = candles.close.data();
+                series.signal = signal.data();
+                series.strength = strength.data();
+                series.bars = candles.size();
+                BacktestResult backtest = backtester.run(series);
+
+                SweepResult &result = results[c];
+                result.mean_total_return += backtest.total_return;
+                result.mean_annualized_return += backtest.annualized_return;
+                result.mean_sharpe += backtest.sharpe;
+                result.mean_max_drawdown += backtest.max_drawdown;
+                result.mean_turnover += backtest.turnover;
+                result.trades += backtest.trades;
+                result.winning_trades += backtest.winning_trades;
+            },
+            [](size_t) {});
+    }
+
+    double count = static_cast<double>(symbols.size());
+    for (SweepResult &result : results)
+    {
+        result.mean_total_return /= count;
+        result.mean_annualized_return /= count;
+        result.mean_sharpe /= count;
+        result.mean_max_drawdown /= count;
+        result.mean_turnover /= count;
+        result.hit_rate = result.trades > 0 ? static_cast<double>(result.winning_trades) / result.trades : 0.0;
+        result.score = scoreOf(result);
+    }
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult &a, const SweepResult &b)
+                     { return a.score > b.score; });
+    return results;
+}
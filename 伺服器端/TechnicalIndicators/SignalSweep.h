@@ -0,0 +1,89 @@
+#ifndef SIGNAL_SWEEP_H
+#define SIGNAL_SWEEP_H
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+#include "IndicatorPipeline.h"
+#include "Tech_Analysis.h"
+#include "Backtester.h"
+
+class ParallelBatch;
+
+// 一檔股票在參數掃描中共用的指標快取：每個 EMA 週期、RSI 週期只計算一次，
+// KD(9,3) 與設定無關只算一次。prepare() 之後為唯讀，可由多條執行緒同時讀取
+class SweepCache
+{
+public:
+    explicit SweepCache(const CandleColumns &candles);
+
+    // 預先計算 configs 用到的所有 EMA 與 RSI 週期
+    void prepare(const std::vector<SignalConfig> &configs);
+    // 產生與 IndicatorPipeline 相同的訊號欄位（長度 size()），所需週期須已 prepare
+    void signals(const SignalConfig &config, int lookback, signed char *signal, signed char *strength) const;
+
+    size_t size() const { return candles.size(); }
+    const CandleColumns &getCandles() const { return candles; }
+    size_t emaCount() const { return emas.size(); }
+
+private:
+    const CandleColumns &candles;
+    int invalid_from; // 第一筆無效收盤價的索引，之後的 MACD 皆為 0
+    std::vector<KDResult> kd;
+    std::map<int, std::vector<double>> emas; // 週期 -> 以 SMA 為種子的 EMA，種子之前為 0
+    std::map<std::pair<int, RSIMode>, std::vector<double>> rsis;
+};
+
+// 排名依據的回測指標（皆為越大越好，跨股票取平均）
+enum class SweepMetric
+{
+    Sharpe,
+    TotalReturn,
+    AnnualizedReturn,
+    HitRate,
+    Calmar // 年化報酬 / 最大回撤
+};
+
+// 單一設定跨所有股票的回測彙總
+struct SweepResult
+{
+    SignalConfig config;
+    double score = 0.0; // 排名用的指標值
+    double mean_total_return = 0.0;
+    double mean_annualized_return = 0.0;
+    double mean_sharpe = 0.0;
+    double mean_max_drawdown = 0.0;
+    double mean_turnover = 0.0;
+    int trades = 0;
+    int winning_trades = 0;
+    double hit_rate = 0.0; // 全部交易中獲利的比例
+};
+
+// SignalConfig 參數網格掃描：逐檔建立共用快取，再把各設定分散到執行緒上產生訊號並回測，
+// 最後依指定指標由高到低排序
+class SignalSweep
+{
+public:
+    SignalSweep(const BacktestConfig &backtest, SweepMetric metric);
+
+    // 以 base 為底組合各參數清單，略過 ema_fast >= ema_slow 與 oversold >= overbought 的組合
+    static std::vector<SignalConfig> grid(const SignalConfig &base,
+                                          const std::vector<int> &ema_fast,
+                                          const std::vector<int> &ema_slow,
+                                          const std::vector<int> &signal_period,
+                                          const std::vector<double> &rsi_overbought,
+                                          const std::vector<double> &rsi_oversold);
+    // lookback 依 KLineMain 慣例為 ema_slow + signal_period - 1
+    static int lookbackOf(const SignalConfig &config) { return config.ema_slow + config.signal_period - 1; }
+
+    std::vector<SweepResult> run(const std::vector<CandleColumns> &symbols, const std::vector<SignalConfig> &configs,
+                                 const ParallelBatch &batch) const;
+
+private:
+    double scoreOf(const SweepResult &result) const;
+
+    Backtester backtester;
+    SweepMetric metric;
+};
+
+#endif
@@ -0,0 +1,110 @@
+// SignalConfig 參數掃描的效能測試：與逐設定呼叫 IndicatorPipeline 再回測的暴力法比對訊號與排名
+// 用法：SignalSweepBenchmark [股票數=50] [年數=10] [執行緒數=0]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "SignalSweep.h"
+#include "IndicatorPipeline.h"
+#include "IndicatorState.h"
+#include "ParallelBatch.h"
+#include "SyntheticCandles.h"
+
+namespace
+{
+    // 幾何布朗運動產生的模擬 K 線
+    std::vector<CandleColumns> generateSymbols(size_t symbols, size_t steps)
+    {
+        SyntheticCandles generator(20240601);
+        std::vector<CandleColumns> result(symbols);
+        for (size_t s = 0; s < symbols; ++s)
+        {
+            result[s].reserve(steps);
+            generator.reset(SyntheticCandles::startPrice(s));
+            for (size_t t = 0; t < steps; ++t)
+            {
+                SyntheticCandle c = generator.next();
+                result[s].push_back(Candle(c.open, c.high, c.low, c.close, c.volume));
+            }
+        }
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t symbols = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+    size_t years = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    std::vector<CandleColumns> data = generateSymbols(symbols, years * 252);
+
+    SignalConfig base;
+    base.price_change_threshold = 0.005;
+    base.rsi_period = 14;
+    std::vector<SignalConfig> configs = SignalSweep::grid(base, {5, 8, 12, 16}, {20, 26, 35, 50}, {5, 9, 12},
+                                                          {65.0, 70.0, 80.0}, {20.0, 30.0, 35.0});
+    BacktestConfig backtest_config;
+    backtest_config.allow_short = true;
+    SignalSweep sweep(backtest_config, SweepMetric::Sharpe);
+    ParallelBatch batch(threads);
+
+    // 暴力法：每個設定對每檔股票完整跑一次指標管線，同時檢查快取產生的訊號欄位是否一致
+    Backtester backtester(backtest_config);
+    std::vector<double> brute_sharpe(configs.size(), 0.0);
+    double brute_ms = elapsedMs([&]
+                                {
+        for (size_t c = 0; c < configs.size(); ++c)
+        {
+            IndicatorPipeline pipeline(configs[c]);
+            for (const CandleColumns &candles : data)
+            {
+                IndicatorColumns indicators;
+                pipeline.run(candles, indicators, SignalSweep::lookbackOf(configs[c]));
+                brute_sharpe[c] += backtester.run(candles, indicators).sharpe / symbols;
+            }
+        } });
+
+    size_t mismatches = 0;
+    for (const CandleColumns &candles : data)
+    {
+        SweepCache cache(candles);
+        cache.prepare(configs);
+        std::vector<signed char> signal(candles.size()), strength(candles.size());
+        for (const SignalConfig &config : configs)
+        {
+            IndicatorColumns indicators;
+            IndicatorPipeline(config).run(candles, indicators, SignalSweep::lookbackOf(config));
+            cache.signals(config, SignalSweep::lookbackOf(config), signal.data(), strength.data());
+            mismatches += signal != indicators.signal || strength != indicators.strength;
+        }
+    }
+
+    std::vector<SweepResult> ranked;
+    double sweep_ms = elapsedMs([&]
+                                { ranked = sweep.run(data, configs, batch); });
+
+    // 排名第一的設定須與暴力法的最佳 Sharpe 相同
+    double brute_best = *std::max_element(brute_sharpe.begin(), brute_sharpe.end());
+    bool same_best = !ranked.empty() && std::fabs(ranked.front().score - brute_best) <= 1e-9 * std::max(1.0, std::fabs(brute_best));
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "股票數 " << symbols << "，每檔 " << years * 252 << " 根 K 線，設定數 " << configs.size() << "\n"
+              << "暴力法:   " << brute_ms << " ms\n"
+              << "共用快取: " << sweep_ms << " ms（" << batch.getThreadCount() << " 執行緒），加速 " << brute_ms / sweep_ms << " 倍\n";
+    std::cout << "前五名（依平均 Sharpe）:\n"
+              << std::setprecision(4);
+    for (size_t r = 0; r < ranked.size() && r < 5; ++r)
+    {
+        const SweepResult &result = ranked[r];
+        std::cout << "  EMA(" << result.config.ema_fast << "," << result.config.ema_slow << "," << result.config.signal_period
+                  << ") RSI " << result.config.rsi_oversold << "/" << result.config.rsi_overbought
+                  << "  Sharpe " << result.score << "  年化報酬 " << result.mean_annualized_return
+                  << "  最大回撤 " << result.mean_max_drawdown << "  勝率 " << result.hit_rate << "\n";
+    }
+    bool ok = mismatches == 0 && same_best;
+    std::cout << (ok ? "結果一致" : "結果不一致: " + std::to_string(mismatches)) << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#include "SymbolCheckpoint.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+
+namespace
+{
+    const int kCheckpointVersion = 1;
+
+    // FNV-1a 64 位元
+    void hashBytes(uint64_t &hash, const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    json aggregateToJson(const PeriodAggregate &aggregate)
+    {
+        return json{{"key", aggregate.key}, {"first_day", aggregate.first_day}, {"last_day", aggregate.last_day},
+                    {"bars", aggregate.bars}, {"open", aggregate.open}, {"high", aggregate.high},
+                    {"low", aggregate.low}, {"close", aggregate.close}, {"volume", aggregate.volume}};
+    }
+
+    PeriodAggregate aggregateFromJson(const json &j)
+    {
+        PeriodAggregate aggregate;
+        aggregate.key = j.at("key").get<int>();
+        aggregate.first_day = j.at("first_day").get<int>();
+        aggregate.last_day = j.at("last_day").get<int>();
+        aggregate.bars = j.at("bars").get<int>();
+        aggregate.open = j.at("open").get<double>();
+        aggregate.high = j.at("high").get<double>();
+        aggregate.low = j.at("low").get<double>();
+        aggregate.close = j.at("close").get<double>();
+        aggregate.volume = j.at("volume").get<long long>();
+        return aggregate;
+    }
+
+    Timeframe timeframeFromName(const std::string &name)
+    {
+        for (Timeframe timeframe : {Timeframe::Daily, Timeframe::Weekly, Timeframe::Monthly})
+        {
+            if (name == timeframeName(timeframe))
+            {
+                return timeframe;
+            }
+        }
+        throw std::runtime_error("unknown timeframe " + name);
+    }
+}
+
+SymbolCheckpoint::SymbolCheckpoint(const SignalConfig &config, int lookback) : state(config, lookback) {}
+
+SymbolCheckpoint::SymbolCheckpoint(const IndicatorState &state) : state(state) {}
+
+bool SymbolCheckpoint::matchesConfig(const SignalConfig &config, int lookback) const
+{
+    const SignalConfig &saved = state.getConfig();
+    return state.getLookback() == lookback &&
+           saved.price_change_threshold == config.price_change_threshold &&
+           saved.ema_fast == config.ema_fast && saved.ema_slow == config.ema_slow &&
+           saved.signal_period == config.signal_period &&
+           saved.rsi_overbought == config.rsi_overbought && saved.rsi_oversold == config.rsi_oversold &&
+           saved.rsi_period == config.rsi_period && saved.rsi_mode == config.rsi_mode;
+}
+
+uint64_t SymbolCheckpoint::hashBars(const DailySeries &series, size_t end, size_t count)
+{
+    uint64_t hash = 14695981039346656037ull;
+    size_t begin = end > count ? end - count : 0;
+    const CandleColumns &c = series.candles;
+    for (size_t i = begin; i < end; ++i)
+    {
+        hashBytes(hash, &series.days[i], sizeof(int));
+        hashBytes(hash, &c.open[i], sizeof(double));
+        hashBytes(hash, &c.high[i], sizeof(double));
+        hashBytes(hash, &c.low[i], sizeof(double));
+        hashBytes(hash, &c.close[i], sizeof(double));
+        hashBytes(hash, &c.volume[i], sizeof(c.volume[i]));
+    }
+    return hash;
+}
+
+SymbolCheckpoint::Match SymbolCheckpoint::compare(const DailySeries &series) const
+{
+    if (bars == 0 || series.size() < bars || series.days[0] != first_day || series.days[bars - 1] != last_day ||
+        hashBars(series, bars, kTailBars) != tail_hash)
+    {
+        return Match::Changed;
+    }
+    return series.size() == bars ? Match::Unchanged : Match::Appended;
+}
+
+void SymbolCheckpoint::record(const DailySeries &series, const IndicatorState &indicator_state)
+{
+    state = indicator_state;
+    bars = series.size();
+    first_day = bars ? series.days.front() : 0;
+    last_day = bars ? series.days.back() : 0;
+    tail_hash = hashBars(series, bars, kTailBars);
+    meta_data = series.meta_data;
+}
+
+json SymbolCheckpoint::toJson() const
+{
+    json j;
+    j["version"] = kCheckpointVersion;
+    j["bars"] = bars;
+    j["first_date"] = formatDayNumber(first_day);
+    j["last_date"] = formatDayNumber(last_day);
+    j["tail_bars"] = kTailBars;
+    j["tail_hash"] = tail_hash;
+    j["output_style"] = output_style;
+    j["output_size"] = output_size;
+    j["meta_data"] = meta_data;
+    j["indicators"] = state.toJson();
+    // 未輸出週 K / 月 K 時省略此欄，下次輸出時從頭計算
+    if (!timeframes.empty())
+    {
+        json outputs = json::array();
+        for (const TimeframeOutput &output : timeframes)
+        {
+            outputs.push_back(json{{"timeframe", timeframeName(output.resume.timeframe)},
+                                   {"indicators", output.resume.state.toJson()},
+                                   {"partial", aggregateToJson(output.resume.partial)},
+                                   {"completed_size", output.completed_size},
+                                   {"output_size", output.output_size}});
+        }
+        j["timeframes"] = outputs;
+    }
+    return j;
+}
+
+bool SymbolCheckpoint::save(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "無法寫入檢查點檔: " << path << std::endl;
+        return false;
+    }
+    file << toJson().dump();
+    return static_cast<bool>(file);
+}
+
+bool SymbolCheckpoint::load(const std::string &path, SymbolCheckpoint &checkpoint)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    try
+    {
+        json j;
+        file >> j;
+        if (j.at("version").get<int>() != kCheckpointVersion || j.at("tail_bars").get<size_t>() != kTailBars)
+        {
+            throw std::runtime_error("unsupported checkpoint version");
+        }
+        SymbolCheckpoint loaded(IndicatorState::fromJson(j.at("indicators")));
+        std::string first_date = j.at("first_date").get<std::string>();
+        std::string last_date = j.at("last_date").get<std::string>();
+        if (!parseDayNumber(first_date.data(), first_date.size(), loaded.first_day) ||
+            !parseDayNumber(last_date.data(), last_date.size(), loaded.last_day))
+        {
+            throw std::runtime_error("invalid checkpoint date");
+        }
+        loaded.bars = j.at("bars").get<size_t>();
+        loaded.tail_hash = j.at("tail_hash").get<uint64_t>();
+        loaded.output_style = j.at("output_style").get<std::string>();
+        loaded.output_size = j.at("output_size").get<uint64_t>();
+        loaded.meta_data = j.at("meta_data");
+        if (j.contains("timeframes"))
+        {
+            for (const json &output : j.at("timeframes"))
+            {
+                TimeframeState resume{timeframeFromName(output.at("timeframe").get<std::string>()),
+                                      IndicatorState::fromJson(output.at("indicators")),
+                                      aggregateFromJson(output.at("partial"))};
+                loaded.timeframes.push_back(TimeframeOutput{resume, output.at("completed_size").get<uint64_t>(),
+                                                            output.at("output_size").get<uint64_t>()});
+            }
+        }
+        checkpoint = loaded;
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "檢查點檔格式錯誤 (" << path << "): " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SYMBOL_CHECKPOINT_H
+#define SYMBOL_CHECKPOINT_H
+#include <cstdint>
+#include <string>
+#include "DailySeriesReader.h"
+#include "IndicatorState.h"
+#include "Resampler.h"
+#include "json.hpp"
+
+// 單一股票的增量處理檢查點：最後處理的 K 線、輸入尾端雜湊、指標遞推狀態與已寫出的輸出檔資訊。
+// 重跑時若輸入的前段與檢查點一致，只需從新增的 K 線接續計算並附加到輸出檔
+class SymbolCheckpoint
+{
+public:
+    // 比對輸入是否被修改時，雜湊檢查點之前的最後幾根 K 線
+    static const size_t kTailBars = 32;
+
+    SymbolCheckpoint(const SignalConfig &config, int lookback);
+    explicit SymbolCheckpoint(const IndicatorState &state);
+
+    // 檢查點的指標參數與目前設定相同時才能接續計算
+    bool matchesConfig(const SignalConfig &config, int lookback) const;
+
+    // 檢查點涵蓋 series 的前 bars 根；之後的 K 線即為新增的尾端
+    enum class Match
+    {
+        Unchanged, // 與檢查點完全相同
+        Appended,  // 前段一致，尾端有新 K 線
+        Changed    // 歷史資料被修改、截斷或起點不同，需要全部重算
+    };
+    Match compare(const DailySeries &series) const;
+
+    // 記錄已處理到 series 的最後一根
+    void record(const DailySeries &series, const IndicatorState &indicator_state);
+
+    static uint64_t hashBars(const DailySeries &series, size_t end, size_t count);
+
+    IndicatorState state;
+    size_t bars = 0;
+    int first_day = 0;
+    int last_day = 0;
+    uint64_t tail_hash = 0;
+    // 輸出檔資訊：附加前確認檔案未被其他程式改動
+    std::string output_style;
+    uint64_t output_size = 0;
+    nlohmann::json meta_data = nlohmann::json::object();
+
+    // 週 K / 月 K 輸出檔：遞推狀態與檔案大小。最後一列為暫算的未結束週期，
+    // completed_size 為不含該列時的大小（0 表示無法接續），下次執行截回此處再附加
+    struct TimeframeOutput
+    {
+        TimeframeState resume;
+        uint64_t completed_size;
+        uint64_t output_size;
+    };
+    std::vector<TimeframeOutput> timeframes; // 未輸出週 K / 月 K 時為空
+
+    nlohmann::json toJson() const;
+    bool save(const std::string &path) const;
+    // 檔案不存在或格式不符時回傳 false，checkpoint 保持不變
+    static bool load(const std::string &path, SymbolCheckpoint &checkpoint);
+};
+
+#endif
@@ -0,0 +1,378 @@
+#include "SymbolProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include "IndicatorState.h"
+#include "ColumnarFile.h"
+#include "CompactCandles.h"
+#include "SymbolCheckpoint.h"
+#include "Resampler.h"
+#include "TradeSignal.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// 取有限值，否則回傳 0
+static double finiteOrZero(double value)
+{
+    return std::isfinite(value) ? value : 0.0;
+}
+
+void printRecords(std::ostream &out, const CandleColumns &columns, const IndicatorColumns &indicators, size_t first_day)
+{
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        double open = columns.open[i], high = columns.high[i], low = columns.low[i], close = columns.close[i];
+        size_t day = first_day + i + 1;
+        out << std::fixed << std::setprecision(4);
+        out << "Day" << day << ".open=" << open << "\n";
+        out << "Day" << day << ".high=" << high << "\n";
+        out << "Day" << day << ".low=" << low << "\n";
+        out << "Day" << day << ".close=" << close << "\n";
+        out << "Day" << day << ".volume=" << static_cast<double>(columns.volume[i]) << "\n";
+        out << "Day" << day << ".ma5=" << finiteOrZero(indicators.ma5[i]) << "\n";
+        out << "Day" << day << ".ma10=" << finiteOrZero(indicators.ma10[i]) << "\n";
+        out << "Day" << day << ".ma20=" << finiteOrZero(indicators.ma20[i]) << "\n";
+        out << "Day" << day << ".k=" << finiteOrZero(indicators.k[i]) << "\n";
+        out << "Day" << day << ".d=" << finiteOrZero(indicators.d[i]) << "\n";
+        out << "Day" << day << ".rsi=" << finiteOrZero(indicators.rsi[i]) << "\n";
+        out << "Day" << day << ".macd_line=" << finiteOrZero(indicators.macd_line[i]) << "\n";
+        out << "Day" << day << ".signal_line=" << finiteOrZero(indicators.signal_line[i]) << "\n";
+        out << "Day" << day << ".histogram=" << finiteOrZero(indicators.histogram[i]) << "\n";
+        out << "Day" << day << ".price_change_percent=" << finiteOrZero(indicators.price_change_percent[i]) << "\n";
+        out << "Day" << day << ".signal=" << signalText(indicators.signal[i]) << "\n";
+        out << "Day" << day << ".strength=" << strengthText(indicators.strength[i]) << "\n";
+        out << "Day" << day << ".body_size=" << std::abs(close - open) << "\n";
+        out << "Day" << day << ".body_type=" << (close > open ? "Bullish" : (close < open ? "Bearish" : "Doji")) << "\n";
+        out << "Day" << day << ".upper_shadow=" << (high - std::max(open, close)) << "\n";
+        out << "Day" << day << ".lower_shadow=" << (std::min(open, close) - low) << "\n";
+        out << "Day" << day << ".bollinger_upper=" << finiteOrZero(indicators.bollinger_upper[i]) << "\n";
+        out << "Day" << day << ".bollinger_lower=" << finiteOrZero(indicators.bollinger_lower[i]) << "\n";
+        out << "Day" << day << ".atr=" << finiteOrZero(indicators.atr[i]) << "\n";
+        out << "Day" << day << ".obv=" << finiteOrZero(indicators.obv[i]) << "\n";
+        out << "Day" << day << ".vwap=" << finiteOrZero(indicators.vwap[i]) << "\n";
+    }
+}
+
+// 週 K / 月 K 檔的 Meta Data：以 "6. Partial Period" 標示最後一列（尚未結束的週期）的日期
+static json partialPeriodMeta(const json &meta_data, const PeriodAggregate &partial)
+{
+    json meta = meta_data;
+    if (partial.bars > 0)
+    {
+        meta["6. Partial Period"] = formatDayNumber(partial.last_day);
+    }
+    return meta;
+}
+
+static std::vector<std::string> periodDates(const TimeframeSeries &series)
+{
+    std::vector<std::string> dates;
+    dates.reserve(series.days.size());
+    for (int day : series.days)
+    {
+        dates.push_back(formatDayNumber(day));
+    }
+    return dates;
+}
+
+// 把 series 的暫算列（最後一列）接在只含已結束週期、大小為 output.completed_size 的檔案之後
+static bool appendPartialPeriod(ProcessedJsonWriter &writer, const std::string &path, const json &meta_data,
+                                const TimeframeSeries &series, size_t completed, SymbolCheckpoint::TimeframeOutput &output)
+{
+    TimeframeSeries partial = series.rows(completed, series.size());
+    return writer.appendDays(path, output.completed_size, meta_data, meta_data, periodDates(partial), partial.candles,
+                             partial.indicators, output.output_size);
+}
+
+// 重寫整個週期檔。有已結束的週期時先只寫這部分並記下大小，下次才能截掉暫算列接續
+static bool writeTimeframe(ProcessedJsonWriter &writer, const std::string &path, const json &meta_data,
+                           const TimeframeSeries &series, SymbolCheckpoint::TimeframeOutput &output)
+{
+    std::error_code ec;
+    size_t completed = series.size() - (series.last_partial ? 1 : 0);
+    if (completed == 0)
+    {
+        output.completed_size = 0;
+        bool written = writer.writeFile(path, meta_data, periodDates(series), series.candles, series.indicators);
+        output.output_size = fs::file_size(path, ec);
+        return written && !ec;
+    }
+    TimeframeSeries head = series.rows(0, completed);
+    if (!writer.writeFile(path, meta_data, periodDates(head), head.candles, head.indicators))
+    {
+        return false;
+    }
+    output.completed_size = fs::file_size(path, ec);
+    return !ec && appendPartialPeriod(writer, path, meta_data, series, completed, output);
+}
+
+// 截掉上次的暫算列，附加接續後新結束的週期與新的暫算列；檔案與檢查點不符時回傳 false，由呼叫端重寫
+static bool appendTimeframe(ProcessedJsonWriter &writer, const std::string &path, const json &old_meta_data,
+                            const json &meta_data, const SymbolCheckpoint::TimeframeOutput &previous,
+                            const TimeframeSeries &series, SymbolCheckpoint::TimeframeOutput &output)
+{
+    std::error_code ec;
+    if (previous.completed_size == 0 || fs::file_size(path, ec) != previous.output_size || ec)
+    {
+        return false;
+    }
+    size_t completed = series.size() - (series.last_partial ? 1 : 0);
+    TimeframeSeries head = series.rows(0, completed);
+    return writer.truncateDays(path, previous.completed_size) &&
+           writer.appendDays(path, previous.completed_size, old_meta_data, meta_data, periodDates(head), head.candles,
+                             head.indicators, output.completed_size) &&
+           appendPartialPeriod(writer, path, meta_data, series, completed, output);
+}
+
+FileResult processFile(const std::string &filename, const std::string &output_folder_path,
+                       const OutputOptions &options)
+{
+    StageClock clock;
+
+    // 串流解析日 K 資料，直接得到依日期升序的 K 線欄位
+    DailySeries series;
+    std::ostringstream err;
+    if (!DailySeriesReader::readFile(filename, series, err))
+    {
+        FileResult result;
+        result.output = "正在處理檔案: " + filename + "\n";
+        result.errors = err.str();
+        return result;
+    }
+    double parse_ms = clock.lap();
+    FileResult result = processSeries(filename, series, output_folder_path, options);
+    result.timings.parse += parse_ms;
+    return result;
+}
+
+FileResult processSeries(const std::string &filename, const DailySeries &series, const std::string &output_folder_path,
+                         const OutputOptions &options)
+{
+    FileResult result;
+    std::ostringstream out, err;
+    StageClock clock;
+    out << "正在處理檔案: " << filename << "\n";
+
+    const json &meta_data = series.meta_data;
+    const CandleColumns &columns = series.candles;
+    std::vector<std::string> dates = series.dateStrings();
+    result.timings.parse = clock.lap();
+
+    SignalConfig config;
+    config.price_change_threshold = 0.005;
+    config.ema_fast = 12;
+    config.ema_slow = 26;
+    config.signal_period = 9;
+    config.rsi_overbought = 70.0;
+    config.rsi_oversold = 30.0;
+    config.rsi_period = 14;
+    config.rsi_mode = RSIMode::Simple;
+    const int lookback = config.ema_slow + config.signal_period - 1;
+
+    // 生成輸出檔案路徑（在輸出資料夾中，檔案名後添加 _processed）
+    std::string stem = fs::path(filename).stem().string();
+    std::string output_filepath = (fs::path(output_folder_path) / (stem + "_processed.json")).string();
+    std::string columnar_filepath = (fs::path(output_folder_path) / (stem + "_processed.kcol")).string();
+    std::string checkpoint_filepath = (fs::path(output_folder_path) / (stem + "_processed.checkpoint")).string();
+    std::string style_name = options.style == ProcessedJsonWriter::Style::Compact ? "compact" : "indented";
+    ProcessedJsonWriter writer(options.style);
+
+    // 檢查點與目前設定、輸出檔都一致，且輸入前段未被修改時，只計算新增的尾端
+    SymbolCheckpoint checkpoint(config, lookback);
+    std::error_code ec;
+    bool resume = options.incremental && SymbolCheckpoint::load(checkpoint_filepath, checkpoint) &&
+                  checkpoint.matchesConfig(config, lookback) && checkpoint.output_style == style_name &&
+                  fs::file_size(output_filepath, ec) == checkpoint.output_size && !ec &&
+                  checkpoint.compare(series) != SymbolCheckpoint::Match::Changed;
+
+    IndicatorPipeline pipeline(config);
+    IndicatorState state(config, lookback);
+    uint64_t output_size = 0;
+    if (resume)
+    {
+        size_t first = checkpoint.bars;
+        CandleColumns tail;
+        tail.reserve(columns.size() - first);
+        tail.open.assign(columns.open.begin() + first, columns.open.end());
+        tail.high.assign(columns.high.begin() + first, columns.high.end());
+        tail.low.assign(columns.low.begin() + first, columns.low.end());
+        tail.close.assign(columns.close.begin() + first, columns.close.end());
+        tail.volume.assign(columns.volume.begin() + first, columns.volume.end());
+        std::vector<std::string> tail_dates(dates.begin() + first, dates.end());
+
+        // 從檢查點的遞推狀態接續計算新增的 K 線
+        IndicatorColumns indicators;
+        state = checkpoint.state;
+        pipeline.run(tail, indicators, state);
+        if (!dates.empty())
+        {
+            state.setLastDate(dates.back());
+        }
+        result.timings.compute = clock.lap();
+
+        // 附加到既有輸出檔；格式不符時改為重新計算並重寫
+        resume = writer.appendDays(output_filepath, checkpoint.output_size, checkpoint.meta_data, meta_data,
+                                   tail_dates, tail, indicators, output_size);
+        if (resume)
+        {
+            if (tail.size() > 0)
+            {
+                out << "\n=== 檔案 " << filename << " 的新增結果（自 Day" << (first + 1) << " 起）===\n";
+                printRecords(out, tail, indicators, first);
+                out << "=====================================\n\n";
+                out << "已附加 " << tail.size() << " 筆至輸出檔案: " << output_filepath << "\n";
+            }
+            else
+            {
+                out << "無新增 K 線，沿用輸出檔案: " << output_filepath << "\n";
+            }
+
+            // 欄位檔需要完整的指標欄位：沿用既有檔案的值，檔案不符時才從頭計算
+            if (options.columnar)
+            {
+                bool written = ColumnarFileWriter::appendRows(columnar_filepath, meta_data, series.days, columns, indicators);
+                if (!written)
+                {
+                    IndicatorColumns all;
+                    pipeline.run(columns, all, lookback);
+                    written = ColumnarFileWriter::write(columnar_filepath, meta_data, series.days, columns, all);
+                }
+                if (written)
+                {
+                    out << "已生成欄位檔: " << columnar_filepath << "\n";
+                }
+                else
+                {
+                    err << "無法創建欄位檔: " << columnar_filepath << "\n";
+                }
+            }
+        }
+        else
+        {
+            out << "輸出檔案與檢查點不符，重新計算: " << output_filepath << "\n";
+        }
+        result.timings.serialize = clock.lap();
+    }
+
+    if (!resume)
+    {
+        // 單次融合走訪計算所有指標欄位與交易訊號；價格可無損轉為定點時改走緊湊欄位
+        IndicatorColumns indicators;
+        state = IndicatorState(config, lookback);
+        CompactCandleColumns compact;
+        if (CompactCandleColumns::encode(series.days, columns, compact))
+        {
+            pipeline.run(compact, indicators, state);
+        }
+        else
+        {
+            pipeline.run(columns, indicators, state);
+        }
+        if (!dates.empty())
+        {
+            state.setLastDate(dates.back());
+        }
+        result.timings.compute += clock.lap();
+
+        // 輸出記錄到終端（暫存）
+        out << "\n=== 檔案 " << filename << " 的處理結果 ===\n";
+        printRecords(out, columns, indicators);
+        out << "=====================================\n\n";
+        result.timings.serialize += clock.lap();
+
+        // 直接串流寫出 JSON（包含 Meta Data 和所有技術指標欄位），不建立中間 DOM
+        if (!writer.writeFile(output_filepath, meta_data, dates, columns, indicators))
+        {
+            err << "無法創建輸出檔案: " << output_filepath << "\n";
+            result.output = out.str();
+            result.errors = err.str();
+            return result;
+        }
+        output_size = fs::file_size(output_filepath, ec);
+        out << "已生成輸出檔案: " << output_filepath << "\n";
+
+        if (options.columnar)
+        {
+            if (ColumnarFileWriter::write(columnar_filepath, meta_data, series.days, columns, indicators))
+            {
+                out << "已生成欄位檔: " << columnar_filepath << "\n";
+            }
+            else
+            {
+                err << "無法創建欄位檔: " << columnar_filepath << "\n";
+            }
+        }
+        result.timings.serialize += clock.lap();
+    }
+
+    // 同一份已解析的日 K 線單次走訪，產生週 K 與月 K 的指標（最後一個週期為暫算值）。
+    // 日 K 能接續且檢查點有各週期的遞推狀態時，只併入新增的日 K 線並附加到既有輸出檔
+    std::vector<SymbolCheckpoint::TimeframeOutput> timeframe_outputs;
+    if (options.timeframes)
+    {
+        const std::vector<Timeframe> frames = {Timeframe::Weekly, Timeframe::Monthly};
+        MultiTimeframePipeline timeframes(config, lookback, frames);
+        std::vector<TimeframeState> saved;
+        for (const SymbolCheckpoint::TimeframeOutput &output : checkpoint.timeframes)
+        {
+            saved.push_back(output.resume);
+        }
+        bool resume_timeframes = resume && timeframes.restore(saved);
+        timeframes.pushAll(series.days, columns, resume_timeframes ? checkpoint.bars : 0);
+        std::vector<TimeframeState> states = timeframes.states();
+        for (size_t t = 0; t < frames.size(); ++t)
+        {
+            Timeframe timeframe = frames[t];
+            std::string timeframe_filepath =
+                (fs::path(output_folder_path) / (stem + "_" + timeframeName(timeframe) + "_processed.json")).string();
+            SymbolCheckpoint::TimeframeOutput output{states[t], 0, 0};
+            TimeframeSeries resampled = timeframes.result(timeframe);
+            bool written = false;
+            if (resume_timeframes)
+            {
+                const SymbolCheckpoint::TimeframeOutput &previous = checkpoint.timeframes[t];
+                written = appendTimeframe(writer, timeframe_filepath, partialPeriodMeta(checkpoint.meta_data, previous.resume.partial),
+                                          partialPeriodMeta(meta_data, output.resume.partial), previous, resampled, output);
+                if (!written)
+                {
+                    // 輸出檔與檢查點不符，這個週期從頭計算並重寫
+                    MultiTimeframePipeline full(config, lookback, {timeframe});
+                    full.pushAll(series.days, columns);
+                    resampled = full.result(timeframe);
+                }
+            }
+            if (!written)
+            {
+                written = writeTimeframe(writer, timeframe_filepath, partialPeriodMeta(meta_data, output.resume.partial),
+                                         resampled, output);
+            }
+            if (written)
+            {
+                timeframe_outputs.push_back(output);
+                out << "已生成" << timeframeName(timeframe) << "輸出檔案: " << timeframe_filepath << "\n";
+            }
+            else
+            {
+                err << "無法創建輸出檔案: " << timeframe_filepath << "\n";
+            }
+        }
+        result.timings.compute += clock.lap();
+    }
+
+    // 保存檢查點（含指標遞推狀態），下次執行只需處理新增的 K 線
+    checkpoint.record(series, state);
+    checkpoint.output_style = style_name;
+    checkpoint.output_size = output_size;
+    checkpoint.timeframes = timeframe_outputs;
+    checkpoint.save(checkpoint_filepath);
+    result.timings.write = clock.lap();
+
+    result.output = out.str();
+    result.errors = err.str();
+    return result;
+}
+
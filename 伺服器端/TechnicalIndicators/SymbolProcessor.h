@@ -0,0 +1,73 @@
+#ifndef SYMBOL_PROCESSOR_H
+#define SYMBOL_PROCESSOR_H
+#include <chrono>
+#include <ostream>
+#include <string>
+#include "DailySeriesReader.h"
+#include "IndicatorPipeline.h"
+#include "ProcessedJsonWriter.h"
+
+// 各處理階段的累計耗時（毫秒）
+struct StageTimings
+{
+    double parse = 0.0;     // 讀檔、解析 JSON、整理 K 線
+    double compute = 0.0;   // 指標與交易訊號計算
+    double serialize = 0.0; // 產生終端輸出、串流寫出 JSON
+    double write = 0.0;     // 寫出狀態檔、輸出到終端
+
+    void add(const StageTimings &other)
+    {
+        parse += other.parse;
+        compute += other.compute;
+        serialize += other.serialize;
+        write += other.write;
+    }
+};
+
+// 單一檔案的處理結果，終端輸出先暫存，再依檔案順序輸出
+struct FileResult
+{
+    std::string output;
+    std::string errors;
+    StageTimings timings;
+};
+
+// 計時器：回傳上次呼叫至今的毫秒數
+class StageClock
+{
+public:
+    StageClock() : start(std::chrono::steady_clock::now()) {}
+    double lap()
+    {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+        start = now;
+        return elapsed;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// 輸出選項
+struct OutputOptions
+{
+    ProcessedJsonWriter::Style style = ProcessedJsonWriter::Style::Indented;
+    bool columnar = false;   // 另外輸出可 mmap 的 .kcol 欄位檔
+    bool incremental = true; // 依檢查點只處理新增的 K 線；--full 時全部重算
+    bool timeframes = false; // 另外輸出週 K / 月 K 的指標檔
+};
+
+// 輸出所有記錄，first_day 為第一筆記錄之前已輸出過的天數
+void printRecords(std::ostream &out, const CandleColumns &columns, const IndicatorColumns &indicators, size_t first_day = 0);
+
+// 處理單一 JSON 檔案，可在多條執行緒上同時呼叫
+FileResult processFile(const std::string &filename, const std::string &output_folder_path,
+                       const OutputOptions &options);
+
+// 處理已解析的日 K 資料（例如下載時即時解析的結果）：計算指標、寫出輸出檔與檢查點。
+// filename 為對應的輸入檔路徑，決定輸出檔名與訊息中的檔名
+FileResult processSeries(const std::string &filename, const DailySeries &series, const std::string &output_folder_path,
+                         const OutputOptions &options);
+
+#endif
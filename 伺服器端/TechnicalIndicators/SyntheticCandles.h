@@ -0,0 +1,130 @@
+#ifndef SYNTHETIC_CANDLES_H
+#define SYNTHETIC_CANDLES_H
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+// 效能測試共用工具：幾何布朗運動產生的模擬 K 線、計時與動態配置統計
+
+struct SyntheticCandle
+{
+    double open = 0.0, high = 0.0, low = 0.0, close = 0.0;
+    long long volume = 0;
+};
+
+// 幾何布朗運動：每根 K 線的收盤價乘上 exp(0.0002 + volatility * N(0,1))，
+// 高低價在開收盤之外加上半常態分布的影線。同一種子產生的序列固定，可跨版本比較
+class SyntheticCandles
+{
+public:
+    explicit SyntheticCandles(uint64_t seed, double volatility = 0.02) : rng(seed), volatility(volatility) {}
+
+    // 第 symbol 檔股票的起始價，分散在 20 ~ 215 之間
+    static double startPrice(size_t symbol) { return 20.0 + 5.0 * (symbol % 40); }
+
+    // 開始產生下一檔股票
+    void reset(double start) { price = start; }
+
+    // 只推進收盤價；shift 加在漂移項上（例如共同市場因子）
+    double nextClose(double shift = 0.0)
+    {
+        price *= std::exp(kDrift + shift + volatility * normal(rng));
+        return price;
+    }
+
+    SyntheticCandle next()
+    {
+        SyntheticCandle candle;
+        candle.open = price;
+        candle.close = nextClose();
+        candle.high = std::max(candle.open, candle.close) * (1.0 + kWick * std::fabs(normal(rng)));
+        candle.low = std::min(candle.open, candle.close) * (1.0 - kWick * std::fabs(normal(rng)));
+        candle.volume = shares(rng);
+        return candle;
+    }
+
+    // 與價格共用同一亂數流的標準常態與 [0, 1) 均勻亂數
+    double gaussian() { return normal(rng); }
+    double uniform() { return unit(rng); }
+
+private:
+    static constexpr double kDrift = 0.0002, kWick = 0.005;
+    std::mt19937_64 rng;
+    std::normal_distribution<double> normal{0.0, 1.0};
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    std::uniform_int_distribution<long long> shares{100000, 5000000};
+    double volatility;
+    double price = 100.0;
+};
+
+// 執行一次 body 的耗時（毫秒）
+template <class F>
+double elapsedMs(F &&body)
+{
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 執行 repeat 次取最快的一次（毫秒）
+inline double timeBestMs(const std::function<void()> &body, int repeat = 3)
+{
+    double best = 1e300;
+    for (int run = 0; run < repeat; ++run)
+    {
+        best = std::min(best, elapsedMs(body));
+    }
+    return best;
+}
+
+// 全域 operator new 的累計：count/bytes 為配置次數與要求的位元組數，live/peak 為目前與峰值的實際佔用
+struct AllocationStats
+{
+    size_t count = 0, bytes = 0;
+    size_t live = 0, peak = 0;
+};
+inline AllocationStats g_allocations;
+
+#endif
+
+// 需要統計動態配置的測試程式，在其唯一的翻譯單元中先定義 SYNTHETIC_CANDLES_COUNT_ALLOCATIONS 再引入本檔，
+// operator new/delete 改以 malloc/free 實作並更新 g_allocations（取代函式不可為 inline，故不能放在多個翻譯單元）
+#if defined(SYNTHETIC_CANDLES_COUNT_ALLOCATIONS) && !defined(SYNTHETIC_CANDLES_ALLOCATOR_DEFINED)
+#define SYNTHETIC_CANDLES_ALLOCATOR_DEFINED
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(size_t size)
+{
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    g_allocations.count++;
+    g_allocations.bytes += size;
+    g_allocations.live += malloc_usable_size(p);
+    g_allocations.peak = std::max(g_allocations.peak, g_allocations.live);
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p)
+    {
+        g_allocations.live -= malloc_usable_size(p);
+        std::free(p);
+    }
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+#endif
@@ -26,130 +26,158 @@ double Tech_Analysis::movingAverage(const std::vector<double> &data, int period,
     return count == period ? sum / period : 0.0;
 }
 
-MACDResult MACDResult::macd(const std::vector<double> &data, int index, const SignalConfig &config)
+std::vector<std::vector<double>> Tech_Analysis::movingAverages(const std::vector<double> &data, const std::vector<int> &periods)
+{
+    std::vector<std::vector<double>> results(periods.size(), std::vector<double>(data.size(), 0.0));
+    MovingAverageState state(periods);
+    std::vector<double> row(periods.size(), 0.0);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        state.update(data[i], row.data());
+        for (size_t p = 0; p < periods.size(); ++p)
+        {
+            results[p][i] = row[p];
+        }
+    }
+    return results;
+}
+
+MovingAverageState::MovingAverageState(const std::vector<int> &periods)
+{
+    windows.reserve(periods.size());
+    for (int period : periods)
+    {
+        windows.emplace_back(period);
+    }
+}
+
+void MovingAverageState::update(double value, double *out)
 {
+    bool valid = std::isfinite(value) && value > 0;
+    for (size_t p = 0; p < windows.size(); ++p)
+    {
+        RollingSum &window = windows[p];
+        window.push(value, valid);
+        out[p] = (window.full() && window.invalidCount() == 0) ? window.mean() : 0.0;
+    }
+}
 
+MACDResult MACDResult::macd(const std::vector<double> &data, int index, const SignalConfig &config)
+{
     int min_index = config.ema_slow - 1;
     if (index < min_index || index >= static_cast<int>(data.size()) || !std::isfinite(data[index]))
     {
         return MACDResult(0, 0, 0);
     }
 
-    std::vector<double> ema_fast(data.size(), 0.0), ema_slow(data.size(), 0.0);
-    double k_fast = 2.0 / (config.ema_fast + 1.0);
-    double k_slow = 2.0 / (config.ema_slow + 1.0);
+    MACDState state(config);
+    MACDResult result(0, 0, 0);
+    for (int i = 0; i <= index; ++i)
+    {
+        result = state.update(data[i]);
+    }
+    return result;
+}
 
-    // Compute fast EMA
-    int fast_sma_index = config.ema_fast - 1;
-    if (index >= fast_sma_index)
+std::vector<MACDResult> MACDResult::macdSeries(const std::vector<double> &data, const SignalConfig &config)
+{
+    std::vector<MACDResult> results(data.size(), MACDResult(0, 0, 0));
+    MACDState state(config);
+    for (size_t i = 0; i < data.size(); ++i)
     {
-        double sum = 0.0;
-        for (int i = fast_sma_index - config.ema_fast + 1; i <= fast_sma_index; ++i)
-        {
-            if (i < 0 || i >= static_cast<int>(data.size()) || !std::isfinite(data[i]) || data[i] <= 0)
-            {
-                std::cerr << "Invalid fast EMA data at i=" << i << "\n";
-                return MACDResult(0, 0, 0);
-            }
-            sum += data[i];
-        }
-        ema_fast[fast_sma_index] = sum / config.ema_fast;
-        for (int i = fast_sma_index + 1; i <= index; ++i)
-        {
-            if (i >= static_cast<int>(data.size()) || !std::isfinite(data[i]) || data[i] <= 0)
-            {
-                std::cerr << "Invalid fast EMA data at i=" << i << "\n";
-                return MACDResult(0, 0, 0);
-            }
-            ema_fast[i] = data[i] * k_fast + ema_fast[i - 1] * (1.0 - k_fast);
-        }
+        results[i] = state.update(data[i]);
     }
+    return results;
+}
+
+MACDState::MACDState(const SignalConfig &config)
+    : ema_fast_period(config.ema_fast),
+      ema_slow_period(config.ema_slow),
+      signal_period(config.signal_period),
+      k_fast(2.0 / (config.ema_fast + 1.0)),
+      k_slow(2.0 / (config.ema_slow + 1.0)),
+      k_signal(2.0 / (config.signal_period + 1.0)),
+      index(0),
+      valid(true),
+      ema_fast(0.0),
+      ema_slow(0.0),
+      macd_window(std::max(config.signal_period, 1), 0.0),
+      macd_window_sum(0.0),
+      signal_ema(0.0),
+      signal_decay(1.0)
+{
+}
 
-    // Compute slow EMA
-    int slow_sma_index = config.ema_slow - 1;
-    if (index >= slow_sma_index)
+MACDResult MACDState::update(double close)
+{
+    int i = index++;
+    if (!valid)
     {
-        double sum = 0.0;
-        for (int i = slow_sma_index - config.ema_slow + 1; i <= slow_sma_index; ++i)
+        return MACDResult(0, 0, 0);
+    }
+    if (!std::isfinite(close) || close <= 0)
+    {
+        // 與逐筆版本一致：任何一筆無效價格會使其後所有 MACD 失效
+        std::cerr << "Invalid EMA data at i=" << i << "\n";
+        valid = false;
+        return MACDResult(0, 0, 0);
+    }
+
+    // 前 period 筆累加作為 SMA 種子，之後以 EMA 遞推
+    if (i < ema_fast_period)
+    {
+        ema_fast += close;
+        if (i == ema_fast_period - 1)
         {
-            if (i < 0 || i >= static_cast<int>(data.size()) || !std::isfinite(data[i]) || data[i] <= 0)
-            {
-                std::cerr << "Invalid slow EMA data at i=" << i << "\n";
-                return MACDResult(0, 0, 0);
-            }
-            sum += data[i];
+            ema_fast /= ema_fast_period;
         }
-        ema_slow[slow_sma_index] = sum / config.ema_slow;
-
-        for (int i = slow_sma_index + 1; i <= index; ++i)
+    }
+    else
+    {
+        ema_fast = close * k_fast + ema_fast * (1.0 - k_fast);
+    }
+    if (i < ema_slow_period)
+    {
+        ema_slow += close;
+        if (i == ema_slow_period - 1)
         {
-            if (i >= static_cast<int>(data.size()) || !std::isfinite(data[i]) || data[i] <= 0)
-            {
-                std::cerr << "Invalid slow EMA data at i=" << i << "\n";
-                return MACDResult(0, 0, 0);
-            }
-            ema_slow[i] = data[i] * k_slow + ema_slow[i - 1] * (1.0 - k_slow);
+            ema_slow /= ema_slow_period;
         }
     }
+    else
+    {
+        ema_slow = close * k_slow + ema_slow * (1.0 - k_slow);
+    }
+
+    if (i < ema_slow_period - 1)
+    {
+        return MACDResult(0, 0, 0);
+    }
 
-    double macd_line = ema_fast[index] - ema_slow[index];
+    double fast = (i >= ema_fast_period - 1) ? ema_fast : 0.0;
+    double macd_line = fast - ema_slow;
     if (!std::isfinite(macd_line))
     {
-        std::cerr << "Invalid macd_line at index " << index << ": ema_fast=" << ema_fast[index]
-                  << ", ema_slow=" << ema_slow[index] << "\n";
+        std::cerr << "Invalid macd_line at index " << i << ": ema_fast=" << fast
+                  << ", ema_slow=" << ema_slow << "\n";
+        valid = false;
         return MACDResult(0, 0, 0);
     }
 
-    // Compute signal line
-    double signal_line = 0.0;
-    if (index >= config.ema_slow + config.signal_period - 2)
+    double signal_line = signalLineStep(macd_line, i - (ema_slow_period - 1), signal_period, k_signal, macd_window.data(),
+                                        static_cast<int>(macd_window.size()), macd_window_sum, signal_ema, signal_decay);
+    if (!std::isfinite(signal_line))
     {
-        std::vector<double> macd_values;
-        for (int i = config.ema_slow - 1; i <= index; ++i)
-        {
-            double macd_val = ema_fast[i] - ema_slow[i];
-            if (std::isfinite(macd_val))
-            {
-                macd_values.push_back(macd_val);
-            }
-        }
-        if (macd_values.size() >= static_cast<size_t>(config.signal_period))
-        {
-            int signal_sma_index = config.ema_slow + config.signal_period - 2;
-            if (index >= signal_sma_index)
-            {
-                double sum_signal = 0.0;
-                for (int i = index - config.signal_period + 1; i <= index; ++i)
-                {
-                    double macd_val = ema_fast[i] - ema_slow[i];
-                    if (std::isfinite(macd_val))
-                    {
-                        sum_signal += macd_val;
-                    }
-                }
-                signal_line = sum_signal / config.signal_period;
-                double k_signal = 2.0 / (config.signal_period + 1.0);
-                for (int i = signal_sma_index + 1; i <= index; ++i)
-                {
-                    double macd_val = ema_fast[i] - ema_slow[i];
-                    if (std::isfinite(macd_val))
-                    {
-                        signal_line = macd_val * k_signal + signal_line * (1.0 - k_signal);
-                    }
-                    if (!std::isfinite(signal_line))
-                    {
-                        std::cerr << "Invalid signal_line at index " << i << "\n";
-                        return MACDResult(0, 0, 0);
-                    }
-                }
-            }
-        }
+        std::cerr << "Invalid signal_line at index " << i << "\n";
+        valid = false;
+        return MACDResult(0, 0, 0);
     }
 
     double histogram = macd_line - signal_line;
     if (!std::isfinite(histogram))
     {
-        std::cerr << "Invalid histogram at index " << index << "\n";
+        std::cerr << "Invalid histogram at index " << i << "\n";
+        valid = false;
         return MACDResult(0, 0, 0);
     }
 
@@ -268,6 +296,86 @@ KDResult KDResult::stochasticKD(const std::vector<Candle> &candles, int period,
     return KDResult(k, d);
 }
 
+std::vector<KDResult> KDResult::stochasticKDSeries(const std::vector<Candle> &candles, int period, int sma_period)
+{
+    std::vector<KDResult> results(candles.size(), KDResult(0.0, 0.0));
+    StochasticState state(period, sma_period);
+    for (size_t i = 0; i < candles.size(); ++i)
+    {
+        results[i] = state.update(candles[i].getHigh(), candles[i].getLow(), candles[i].getClose());
+    }
+    return results;
+}
+
+StochasticState::StochasticState(int period, int sma_period)
+    : period(period),
+      sma_period(sma_period),
+      index(0),
+      lowest_low(period, MonotonicWindow::Min),
+      highest_high(period, MonotonicWindow::Max),
+      price_flags(period),
+      k_window(sma_period)
+{
+}
+
+KDResult StochasticState::update(double high, double low, double close)
+{
+    int i = index++;
+    bool price_valid = std::isfinite(low) && std::isfinite(high) && low > 0 && high > 0;
+    lowest_low.push(low, price_valid);
+    highest_high.push(high, price_valid);
+    price_flags.push(0.0, price_valid);
+    if (!price_valid)
+    {
+        std::cerr << "無效 K線數據於索引 " << i << ": low=" << low << ", high=" << high << "\n";
+    }
+
+    if (i < period - 1)
+    {
+        return KDResult(0.0, 0.0);
+    }
+
+    double k = 0.0;
+    bool k_valid = false;
+    if (price_flags.invalidCount() == 0)
+    {
+        if (!std::isfinite(close) || close <= 0)
+        {
+            std::cerr << "無效收盤價於索引 " << i << ": close=" << close << "\n";
+        }
+        else
+        {
+            double ll = lowest_low.value();
+            double hh = highest_high.value();
+            k = (hh == ll) ? 0.0 : ((close - ll) / (hh - ll)) * 100.0;
+            k_valid = std::isfinite(k) && k >= 0 && k <= 100;
+            if (!k_valid)
+            {
+                std::cerr << "無效 K 值於索引 " << i << ": k=" << k << ", close=" << close
+                          << ", lowest_low=" << ll << ", highest_high=" << hh << "\n";
+            }
+        }
+    }
+    k_window.push(k, k_valid);
+    if (!k_valid)
+    {
+        return KDResult(0.0, 0.0);
+    }
+
+    // %D：對最近 sma_period 筆有效 %K 取平均，資料不足時沿用 %K
+    double d = k;
+    if (i >= period + sma_period - 2 && k_window.validCount() > 0)
+    {
+        d = k_window.sum() / k_window.validCount();
+        if (!std::isfinite(d) || d < 0 || d > 100)
+        {
+            std::cerr << "無效 D 值於索引 " << i << ": d=" << d << "\n";
+            d = k;
+        }
+    }
+    return KDResult(k, d);
+}
+
 double RSIResult::rsi(const std::vector<double> &data, int period, int index, const SignalConfig &config)
 {
     if (index < period || index >= static_cast<int>(data.size()))
@@ -275,6 +383,18 @@ double RSIResult::rsi(const std::vector<double> &data, int period, int index, co
         return 0.0;
     }
 
+    if (config.rsi_mode == RSIMode::Wilder)
+    {
+        // Wilder 平滑依賴完整歷史，從頭遞推到 index
+        RSIState state(period, config.rsi_mode);
+        double result = 0.0;
+        for (int i = 0; i <= index; ++i)
+        {
+            result = state.update(data[i]);
+        }
+        return result;
+    }
+
     double gain = 0.0, loss = 0.0;
     for (int i = index - period + 1; i <= index; ++i)
     {
@@ -297,16 +417,177 @@ double RSIResult::rsi(const std::vector<double> &data, int period, int index, co
     gain /= period;
     loss /= period;
 
-    if (loss == 0)
+    return fromAverages(gain, loss);
+}
+
+double RSIResult::fromAverages(double avg_gain, double avg_loss)
+{
+    if (avg_loss == 0)
     {
-        return gain == 0 ? 0.0 : 100.0;
+        return avg_gain == 0 ? 0.0 : 100.0;
     }
-    double rs = gain / loss;
+    double rs = avg_gain / avg_loss;
     double rsi = 100.0 - (100.0 / (1.0 + rs));
     if (!std::isfinite(rsi) || rsi < 0 || rsi > 100)
     {
-        std::cerr << "無效 RSI 於索引 " << index << ": rsi=" << rsi << "\n";
         return 0.0;
     }
     return rsi;
 }
+
+std::vector<double> RSIResult::rsiSeries(const std::vector<double> &data, int period, const SignalConfig &config)
+{
+    std::vector<double> results(data.size(), 0.0);
+    RSIState state(period, config.rsi_mode);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        results[i] = state.update(data[i]);
+    }
+    return results;
+}
+
+RSIState::RSIState(int period, RSIMode mode)
+    : period(period),
+      mode(mode),
+      index(0),
+      prev_close(0.0),
+      gains(period),
+      losses(period),
+      wilder_count(0),
+      avg_gain(0.0),
+      avg_loss(0.0)
+{
+}
+
+double RSIState::update(double close)
+{
+    int i = index++;
+    double diff = close - prev_close;
+    prev_close = close;
+    if (i == 0)
+    {
+        return 0.0;
+    }
+
+    bool valid = std::isfinite(diff);
+    double gain = (diff > 0) ? diff : 0.0;
+    double loss = (diff < 0) ? -diff : 0.0;
+    gains.push(gain, valid);
+    losses.push(loss, valid);
+    if (!valid)
+    {
+        std::cerr << "無效價格差異於索引 " << i << "\n";
+        wilder_count = 0;
+    }
+
+    if (mode == RSIMode::Wilder)
+    {
+        if (!valid)
+        {
+            return 0.0;
+        }
+        // 以前 period 筆漲跌的簡單平均為種子，之後套用 Wilder 平滑
+        wilder_count++;
+        if (wilder_count < period)
+        {
+            return 0.0;
+        }
+        if (wilder_count == period)
+        {
+            avg_gain = gains.sum() / period;
+            avg_loss = losses.sum() / period;
+        }
+        else
+        {
+            avg_gain = (avg_gain * (period - 1) + gain) / period;
+            avg_loss = (avg_loss * (period - 1) + loss) / period;
+        }
+        return RSIResult::fromAverages(avg_gain, avg_loss);
+    }
+
+    if (i < period || gains.invalidCount() > 0)
+    {
+        return 0.0;
+    }
+    return RSIResult::fromAverages(gains.sum() / period, losses.sum() / period);
+}
+
+BollingerState::BollingerState(int period, double width) : width(width), window(period) {}
+
+BollingerResult BollingerState::update(double close)
+{
+    window.push(close, std::isfinite(close) && close > 0);
+    BollingerResult result;
+    if (window.full() && window.invalidCount() == 0)
+    {
+        double band = width * window.stddev();
+        result.middle = window.mean();
+        result.upper = result.middle + band;
+        result.lower = result.middle - band;
+    }
+    return result;
+}
+
+ATRState::ATRState(int period)
+    : prev_close(std::numeric_limits<double>::quiet_NaN()), average(period, ExponentialAverage::Wilder)
+{
+}
+
+double ATRState::update(double high, double low, double close)
+{
+    bool valid = std::isfinite(high) && std::isfinite(low) && std::isfinite(close) && high > 0 && low > 0 && close > 0;
+    if (!valid)
+    {
+        average.push(0.0, false);
+        prev_close = std::numeric_limits<double>::quiet_NaN();
+        return 0.0;
+    }
+    double range = high - low;
+    if (!std::isnan(prev_close))
+    {
+        range = std::max({range, std::abs(high - prev_close), std::abs(low - prev_close)});
+    }
+    prev_close = close;
+    average.push(range);
+    return average.ready() ? average.value() : 0.0;
+}
+
+OBVState::OBVState() : prev_close(std::numeric_limits<double>::quiet_NaN()), obv(0.0) {}
+
+double OBVState::update(double close, long long volume)
+{
+    if (!std::isfinite(close) || close <= 0)
+    {
+        return obv;
+    }
+    if (!std::isnan(prev_close))
+    {
+        if (close > prev_close)
+        {
+            obv += static_cast<double>(volume);
+        }
+        else if (close < prev_close)
+        {
+            obv -= static_cast<double>(volume);
+        }
+    }
+    prev_close = close;
+    return obv;
+}
+
+VWAPState::VWAPState(int period) : price_volume(period), volume(period) {}
+
+double VWAPState::update(double high, double low, double close, long long traded)
+{
+    bool valid = std::isfinite(high) && std::isfinite(low) && std::isfinite(close) &&
+                 high > 0 && low > 0 && close > 0 && traded >= 0;
+    double shares = static_cast<double>(traded);
+    price_volume.push((high + low + close) / 3.0 * shares, valid);
+    volume.push(shares, valid);
+    double total = volume.sum();
+    if (!volume.full() || volume.invalidCount() > 0 || total <= 0.0)
+    {
+        return 0.0;
+    }
+    return price_volume.sum() / total;
+}
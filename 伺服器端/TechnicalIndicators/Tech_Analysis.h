@@ -1,8 +1,10 @@
 #ifndef TECH_ANALYSIS_H
 #define TECH_ANALYSIS_H
 
+#include <cmath>
 #include <vector>
 #include "TradeSignal.h" // 包含 SignalConfig 定義
+#include "RollingWindow.h"
 
 class Candle;
 
@@ -11,6 +13,56 @@ struct MACDResult
     double macdLine, signalLine, histogram;
     MACDResult(double m, double s, double h) : macdLine(m), signalLine(s), histogram(h) {}
     static MACDResult macd(const std::vector<double> &data, int index, const SignalConfig &config);
+    // 一次計算整段序列的 MACD，結果寫入單一輸出緩衝區（長度與 data 相同）
+    static std::vector<MACDResult> macdSeries(const std::vector<double> &data, const SignalConfig &config);
+};
+
+// MACD 訊號線的一步遞推，MACDState 與 SignalSweep 共用。step 為 MACD 線自第一筆起的序號，
+// window 為最近 signal_period 筆 MACD 的環狀視窗（長度 window_size）；前 signal_period - 1 步回傳 0，
+// 第 signal_period 步為視窗平均，之後為平均 * (1-k)^n + 以 0 為初值的 EMA
+inline double signalLineStep(double macd_line, int step, int signal_period, double k_signal, double *window,
+                             int window_size, double &window_sum, double &signal_ema, double &signal_decay)
+{
+    int slot = step % window_size;
+    window_sum += macd_line - window[slot];
+    window[slot] = macd_line;
+    if (step == signal_period - 1)
+    {
+        signal_ema = 0.0;
+        signal_decay = 1.0;
+        return window_sum / signal_period;
+    }
+    if (step >= signal_period)
+    {
+        signal_ema = macd_line * k_signal + signal_ema * (1.0 - k_signal);
+        signal_decay *= (1.0 - k_signal);
+        return window_sum / signal_period * signal_decay + signal_ema;
+    }
+    return 0.0;
+}
+
+// MACD 逐筆遞推狀態：每輸入一筆收盤價以 O(1) 更新快慢 EMA 與訊號線
+class MACDState
+{
+public:
+    explicit MACDState(const SignalConfig &config);
+    MACDResult update(double close);
+    // 最近一次 update 的 MACD 線、訊號線與柱狀體是否已完成暖機且至今輸入皆有效
+    bool lineReady() const { return valid && index >= ema_slow_period; }
+    bool signalReady() const { return valid && index >= ema_slow_period + signal_period - 1; }
+
+private:
+    friend class IndicatorState;
+
+    int ema_fast_period, ema_slow_period, signal_period;
+    double k_fast, k_slow, k_signal;
+    int index;  // 已輸入的資料筆數
+    bool valid; // 至今所有輸入是否皆為有效價格
+    double ema_fast, ema_slow;
+    // 訊號線 = 最近 signal_period 筆 MACD 的平均 * (1-k)^n + 自起始點以 0 為初值的 EMA
+    std::vector<double> macd_window;
+    double macd_window_sum;
+    double signal_ema, signal_decay;
 };
 
 struct KDResult
@@ -20,17 +72,154 @@ struct KDResult
     double getK() const { return k; }
     double getD() const { return d; }
     static KDResult stochasticKD(const std::vector<Candle> &candles, int period, int sma_period, int index);
+    // 以單調佇列一次計算整段序列的 %K/%D，index < period - 1 的位置為 (0, 0)
+    static std::vector<KDResult> stochasticKDSeries(const std::vector<Candle> &candles, int period, int sma_period);
+};
+
+// 隨機指標逐筆遞推狀態：最高/最低價由單調佇列維護，%D 為最近 sma_period 筆有效 %K 的平均
+class StochasticState
+{
+public:
+    StochasticState(int period, int sma_period);
+    KDResult update(double high, double low, double close);
+    // 最近一次 update 的 %K 是否有效；%D 另需累積 sma_period 筆，之前沿用 %K 的值不算有效
+    bool kReady() const { return index >= period && k_window.lastValid(); }
+    bool dReady() const { return kReady() && index >= period + sma_period - 1; }
+
+private:
+    friend class IndicatorState;
+
+    int period, sma_period;
+    int index;
+    MonotonicWindow lowest_low, highest_high;
+    RollingSum price_flags; // 只用來統計視窗內無效最高/最低價的筆數
+    RollingSum k_window;
 };
 
 struct RSIResult
 {
     static double rsi(const std::vector<double> &data, int period, int index, const SignalConfig &config);
+    // 一次計算整段 RSI 序列，平均方式依 config.rsi_mode，index < period 的位置為 0
+    static std::vector<double> rsiSeries(const std::vector<double> &data, int period, const SignalConfig &config);
+    // 由平均漲幅/跌幅換算 RSI，結果不合法時回傳 0
+    static double fromAverages(double avg_gain, double avg_loss);
+};
+
+// RSI 逐筆遞推狀態：Simple 模式維護視窗內漲跌總和，Wilder 模式延續平滑後的平均漲跌
+class RSIState
+{
+public:
+    RSIState(int period, RSIMode mode);
+    double update(double close);
+    // 最近一次 update 的 RSI 是否已累積足夠的有效漲跌
+    bool ready() const
+    {
+        return mode == RSIMode::Wilder ? wilder_count >= period : (index > period && gains.invalidCount() == 0);
+    }
+
+private:
+    friend class IndicatorState;
+
+    int period;
+    RSIMode mode;
+    int index;
+    double prev_close;
+    RollingSum gains, losses;
+    int wilder_count; // Wilder 模式自上次重置以來連續有效的漲跌筆數
+    double avg_gain, avg_loss;
 };
 
 class Tech_Analysis
 {
 public:
     static double movingAverage(const std::vector<double> &data, int period, int index);
+    // 單次走訪計算多個週期的 SMA，回傳值依 periods 順序各為一條與 data 等長的序列
+    static std::vector<std::vector<double>> movingAverages(const std::vector<double> &data, const std::vector<int> &periods);
+};
+
+// 多週期 SMA 的滾動狀態：視窗內任一值非正或非有限時該週期輸出 0
+class MovingAverageState
+{
+public:
+    explicit MovingAverageState(const std::vector<int> &periods);
+    // 輸入一筆資料，依 periods 順序將各週期的 SMA 寫入 out
+    void update(double value, double *out);
+    size_t size() const { return windows.size(); }
+    // 第 p 個週期最近一次輸出的 SMA 是否有效
+    bool ready(size_t p) const { return windows[p].full() && windows[p].invalidCount() == 0; }
+
+private:
+    friend class IndicatorState;
+
+    std::vector<RollingSum> windows;
+};
+
+// 布林通道：中軌為 period 日均價，上下軌為中軌 ± width 倍母體標準差
+struct BollingerResult
+{
+    double upper = 0.0, middle = 0.0, lower = 0.0;
+};
+
+// 布林通道逐筆遞推狀態；視窗未滿或含無效價格時輸出 0
+class BollingerState
+{
+public:
+    BollingerState(int period, double width);
+    BollingerResult update(double close);
+    bool ready() const { return window.full() && window.invalidCount() == 0; }
+
+private:
+    friend class IndicatorState;
+
+    double width;
+    RollingVariance window;
+};
+
+// ATR 逐筆遞推狀態：真實波幅以前 period 筆的平均為種子，之後 Wilder 平滑；
+// 價格無效時重新累積，種子完成前輸出 0
+class ATRState
+{
+public:
+    explicit ATRState(int period);
+    double update(double high, double low, double close);
+    bool ready() const { return average.ready(); }
+
+private:
+    friend class IndicatorState;
+
+    double prev_close; // 前一根有效收盤價，沒有時為 NaN
+    ExponentialAverage average;
+};
+
+// OBV 逐筆遞推狀態：收盤上漲加上當日成交量、下跌減去，第一根為 0；無效收盤價不改變 OBV
+class OBVState
+{
+public:
+    OBVState();
+    double update(double close, long long volume);
+    // 出現過有效收盤價後 OBV 才有意義
+    bool ready() const { return !std::isnan(prev_close); }
+
+private:
+    friend class IndicatorState;
+
+    double prev_close; // 前一根有效收盤價，沒有時為 NaN
+    double obv;
+};
+
+// 滾動 VWAP：period 日內 典型價 (H+L+C)/3 × 成交量 的總和除以成交量總和；
+// 視窗未滿、含無效資料或成交量總和為 0 時輸出 0
+class VWAPState
+{
+public:
+    explicit VWAPState(int period);
+    double update(double high, double low, double close, long long traded);
+    bool ready() const { return volume.full() && volume.invalidCount() == 0 && volume.sum() > 0.0; }
+
+private:
+    friend class IndicatorState;
+
+    RollingSum price_volume, volume;
 };
 
 #endif
\ No newline at end of file
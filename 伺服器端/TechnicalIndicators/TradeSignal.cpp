@@ -18,88 +18,122 @@ std::vector<TradeSignal> generateTradeSignals(const std::vector<Candle> &candles
                                               const SignalConfig &config,
                                               int lookback,
                                               const std::vector<MACDResult> &macd_cache)
+{
+    return generateTradeSignals(candles, config, lookback, macd_cache,
+                                KDResult::stochasticKDSeries(candles, 9, 3),
+                                RSIResult::rsiSeries(closes, config.rsi_period, config));
+}
+
+std::string signalText(int signal)
+{
+    return signal > 0 ? "買進" : (signal < 0 ? "賣出" : "");
+}
+
+std::string strengthText(int strength)
+{
+    return strength >= 2 ? "強" : (strength == 1 ? "中" : "");
+}
+
+std::vector<TradeSignal> generateTradeSignals(const std::vector<Candle> &candles,
+                                              const SignalConfig &config,
+                                              int lookback,
+                                              const std::vector<MACDResult> &macd_cache,
+                                              const std::vector<KDResult> &kd_cache,
+                                              const std::vector<double> &rsi_cache)
 {
     std::vector<TradeSignal> signals;
 
     for (size_t i = lookback; i < candles.size(); ++i)
     {
-        KLine kline(candles[i]);
-        double macd_score = 0.0, kd_score = 0.0, rsi_score = 0.0;
-        int indicator_count = 0;
-
-        // MACD Crossover (Weight: 0.4)
-        if (i >= config.ema_slow - 1)
+        size_t prev = (i > 0) ? i - 1 : i;
+        SignalCode code = scoreSignal(static_cast<int>(i), config,
+                                      macd_cache[i], macd_cache[prev],
+                                      kd_cache[i], kd_cache[prev],
+                                      rsi_cache[i]);
+        if (code.signal != 0)
         {
-            MACDResult macd = macd_cache[i];
-            MACDResult macd_prev = (i > config.ema_slow - 1) ? macd_cache[i - 1] : MACDResult(0, 0, 0);
-            if (std::isfinite(macd.macdLine) && std::isfinite(macd.signalLine) &&
-                std::isfinite(macd_prev.macdLine) && std::isfinite(macd_prev.signalLine))
-            {
-                if (macd.macdLine > macd.signalLine && macd_prev.macdLine <= macd_prev.signalLine)
-                {
-                    macd_score = 0.4; // Bullish
-                    indicator_count++;
-                }
-                else if (macd.macdLine < macd.signalLine && macd_prev.macdLine >= macd_prev.signalLine)
-                {
-                    macd_score = -0.4; // Bearish
-                    indicator_count++;
-                }
-            }
+            signals.emplace_back(i + 1, signalText(code.signal), strengthText(code.strength));
         }
+    }
+
+    return signals;
+}
+
+SignalCode scoreSignal(int i, const SignalConfig &config,
+                       const MACDResult &macd, const MACDResult &macd_prev,
+                       const KDResult &kd, const KDResult &kd_prev,
+                       double rsi)
+{
+    double macd_score = 0.0, kd_score = 0.0, rsi_score = 0.0;
+    int indicator_count = 0;
 
-        // KD Crossover (Weight: 0.3)
-        if (i >= 8)
+    // MACD Crossover (Weight: 0.4)
+    if (i >= config.ema_slow - 1)
+    {
+        double prev_macd_line = (i > config.ema_slow - 1) ? macd_prev.macdLine : 0.0;
+        double prev_signal_line = (i > config.ema_slow - 1) ? macd_prev.signalLine : 0.0;
+        if (std::isfinite(macd.macdLine) && std::isfinite(macd.signalLine) &&
+            std::isfinite(prev_macd_line) && std::isfinite(prev_signal_line))
         {
-            auto kd = KDResult::stochasticKD(candles, 9, 3, i);
-            auto kd_prev = KDResult::stochasticKD(candles, 9, 3, i - 1);
-            double k = kd.getK(), d = kd.getD();
-            double k_prev = kd_prev.getK(), d_prev = kd_prev.getD();
-            if (std::isfinite(k) && std::isfinite(d) && std::isfinite(k_prev) && std::isfinite(d_prev) &&
-                k >= 0 && k <= 100 && d >= 0 && d <= 100 && k_prev >= 0 && k_prev <= 100 && d_prev >= 0 && d_prev <= 100)
+            if (macd.macdLine > macd.signalLine && prev_macd_line <= prev_signal_line)
+            {
+                macd_score = 0.4; // Bullish
+                indicator_count++;
+            }
+            else if (macd.macdLine < macd.signalLine && prev_macd_line >= prev_signal_line)
             {
-                if (k > d && k_prev <= d_prev && k < 80)
-                {
-                    kd_score = 0.3; // Bullish
-                    indicator_count++;
-                }
-                else if (k < d && k_prev >= d_prev && k > 20)
-                {
-                    kd_score = -0.3; // Bearish
-                    indicator_count++;
-                }
+                macd_score = -0.4; // Bearish
+                indicator_count++;
             }
         }
+    }
 
-        // RSI Overbought/Oversold (Weight: 0.3)
-        if (i >= 14)
+    // KD Crossover (Weight: 0.3)
+    if (i >= 8)
+    {
+        double k = kd.getK(), d = kd.getD();
+        double k_prev = kd_prev.getK(), d_prev = kd_prev.getD();
+        if (std::isfinite(k) && std::isfinite(d) && std::isfinite(k_prev) && std::isfinite(d_prev) &&
+            k >= 0 && k <= 100 && d >= 0 && d <= 100 && k_prev >= 0 && k_prev <= 100 && d_prev >= 0 && d_prev <= 100)
         {
-            double rsi = RSIResult::rsi(closes, 14, i, config);
-            if (std::isfinite(rsi) && rsi >= 0 && rsi <= 100)
+            if (k > d && k_prev <= d_prev && k < 80)
+            {
+                kd_score = 0.3; // Bullish
+                indicator_count++;
+            }
+            else if (k < d && k_prev >= d_prev && k > 20)
             {
-                if (rsi > config.rsi_overbought)
-                {                     // 70.0
-                    rsi_score = -0.3; // Bearish
-                    indicator_count++;
-                }
-                else if (rsi < config.rsi_oversold)
-                {                    // 30.0
-                    rsi_score = 0.3; // Bullish
-                    indicator_count++;
-                }
+                kd_score = -0.3; // Bearish
+                indicator_count++;
             }
         }
+    }
 
-        // Determine signal and strength
-        double total_score = macd_score + kd_score + rsi_score;
-        std::string signal, strength;
-        if (indicator_count >= 1)
+    // RSI Overbought/Oversold (Weight: 0.3)
+    if (i >= config.rsi_period)
+    {
+        if (std::isfinite(rsi) && rsi >= 0 && rsi <= 100)
         {
-            signal = (total_score > 0) ? "買進" : "賣出";
-            strength = (indicator_count >= 2 || std::abs(total_score) >= 0.7) ? "強" : "中";
-            signals.emplace_back(i + 1, signal, strength);
+            if (rsi > config.rsi_overbought)
+            {                     // 70.0
+                rsi_score = -0.3; // Bearish
+                indicator_count++;
+            }
+            else if (rsi < config.rsi_oversold)
+            {                    // 30.0
+                rsi_score = 0.3; // Bullish
+                indicator_count++;
+            }
         }
     }
 
-    return signals;
-}
\ No newline at end of file
+    // Determine signal and strength
+    SignalCode code;
+    if (indicator_count >= 1)
+    {
+        double total_score = macd_score + kd_score + rsi_score;
+        code.signal = (total_score > 0) ? 1 : -1;
+        code.strength = (indicator_count >= 2 || std::abs(total_score) >= 0.7) ? 2 : 1;
+    }
+    return code;
+}
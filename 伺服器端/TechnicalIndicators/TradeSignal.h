@@ -4,6 +4,13 @@
 #include <vector>
 #include <string>
 
+// RSI 平均方式：Simple 為視窗內漲跌幅簡單平均，Wilder 為 Wilder 平滑（標準 RSI 定義）
+enum class RSIMode
+{
+    Simple,
+    Wilder
+};
+
 struct SignalConfig
 {
     double price_change_threshold = 0.005;
@@ -12,6 +19,8 @@ struct SignalConfig
     int signal_period = 9;
     double rsi_overbought = 70.0;
     double rsi_oversold = 30.0;
+    int rsi_period = 14;
+    RSIMode rsi_mode = RSIMode::Simple;
 };
 
 class TradeSignal
@@ -28,9 +37,20 @@ private:
     std::string strength;
 };
 
+// 以數值編碼的單根 K 線訊號，供欄位式儲存：signal 1=買進、-1=賣出、0=無；strength 2=強、1=中、0=無
+struct SignalCode
+{
+    signed char signal = 0;
+    signed char strength = 0;
+};
+
+std::string signalText(int signal);
+std::string strengthText(int strength);
+
 class Candle;
 class KLine;
 struct MACDResult;
+struct KDResult;
 
 std::vector<TradeSignal> generateTradeSignals(
     const std::vector<Candle> &candles,
@@ -39,4 +59,19 @@ std::vector<TradeSignal> generateTradeSignals(
     int lookback,
     const std::vector<MACDResult> &macd_cache);
 
+// 使用預先算好的 KD(9,3) 與 RSI 序列，避免每根 K 線重新計算指標
+std::vector<TradeSignal> generateTradeSignals(
+    const std::vector<Candle> &candles,
+    const SignalConfig &config,
+    int lookback,
+    const std::vector<MACDResult> &macd_cache,
+    const std::vector<KDResult> &kd_cache,
+    const std::vector<double> &rsi_cache);
+
+// 依當根與前一根的指標值評分第 i 根 K 線的訊號
+SignalCode scoreSignal(int i, const SignalConfig &config,
+                       const MACDResult &macd, const MACDResult &macd_prev,
+                       const KDResult &kd, const KDResult &kd_prev,
+                       double rsi);
+
 #endif
\ No newline at end of file
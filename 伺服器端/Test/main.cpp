@@ -2,6 +2,7 @@
 #include "NetworkServer.h"
 #include "JsonPacket.h"
 #include "task_pool.h"
+#include "SymbolUniverse.h"
 #include "json.hpp"
 
 #include <iostream>
@@ -18,37 +19,30 @@ int main() {
 
     FileReader fileReader;
 
-    // 🔄 讀取多個 JSON 檔案
-    std::vector<std::string> filenames = {
-        "../TechnicalIndicators/output_json/stock_data_AAPL_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_AMZN_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_GOOGL_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_MSFT_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_NVDA_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_TSLA_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_META_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_INTC_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_ORCL_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_IBM_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_NFLX_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_AMD_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_BABA_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_JPM_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_V_processed.json",
-        "../TechnicalIndicators/output_json/stock_data_UNH_processed.json"
-    };
+    // 🔄 依資料載入系統的股票清單讀取各代碼的指標檔；清單可達數千個代碼，個別檔案缺少時略過
+    std::vector<UniverseEntry> universe;
+    std::string error;
+    if (!loadUniverse("../資料載入系統/symbols.txt", universe, error)) {
+        std::cerr << "[ERROR] " << error << std::endl;
+        return -1;
+    }
 
     std::vector<std::string> json_data_list;
 
-    for (const auto& filename : filenames) {
+    for (const auto& entry : universe) {
+        std::string filename = "../TechnicalIndicators/output_json/stock_data_" + entry.symbol + "_processed.json";
         std::cout << "[INFO] 讀取檔案: " << filename << std::endl;
         std::string json_data = fileReader.readJsonFile(filename);
         if (json_data.empty()) {
-            std::cerr << "[ERROR] 讀取檔案失敗: " << filename << std::endl;
-            return -1;
+            std::cerr << "[ERROR] 讀取檔案失敗，略過: " << filename << std::endl;
+            continue;
         }
         json_data_list.push_back(json_data);
     }
+    if (json_data_list.empty()) {
+        std::cerr << "[ERROR] 沒有可用的指標檔" << std::endl;
+        return -1;
+    }
 
     std::cout << "[INFO] 建立 JSON 陣列..." << std::endl;
     json json_array = json::array();
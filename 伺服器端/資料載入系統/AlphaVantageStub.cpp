@@ -0,0 +1,145 @@
+// AlphaVantageStub.cpp
+// 本機 HTTP 測試伺服器：模擬 Alpha Vantage 的 TIME_SERIES_DAILY 端點，
+// 回傳資料夾中的 stock_data_<代碼>.json，每個回應延遲指定毫秒數，支援 keep-alive 與多個同時連線。
+// 每個請求印出收到的時間、連線編號與當下的連線數，用來驗證抓取程式的限速、並行上限與連線重用（僅支援 POSIX 系統）
+// 用法：alphavantage_stub [連接埠=8080] [延遲毫秒=200] [資料夾=.]
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+    std::string dataDir = ".";
+    int latencyMs = 200;
+    std::atomic<int> openConnections(0), acceptedConnections(0), inFlight(0), maxInFlight(0);
+    std::mutex logMutex;
+    const auto serverStart = std::chrono::steady_clock::now();
+
+    // 取出查詢字串中的參數值
+    std::string queryParam(const std::string& target, const std::string& name) {
+        size_t pos = target.find(name + "=");
+        while (pos != std::string::npos && pos > 0 && target[pos - 1] != '?' && target[pos - 1] != '&') {
+            pos = target.find(name + "=", pos + 1);
+        }
+        if (pos == std::string::npos) {
+            return "";
+        }
+        size_t start = pos + name.size() + 1;
+        return target.substr(start, target.find('&', start) - start);
+    }
+
+    std::string readFile(const std::string& path, bool& found) {
+        std::ifstream in(path, std::ios::binary);
+        found = in.is_open();
+        std::ostringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // 處理單一連線上的所有請求，直到對方關閉或要求 Connection: close
+    void serveConnection(int fd) {
+        int connectionId = ++acceptedConnections;
+        ++openConnections;
+        std::string buffer;
+        char chunk[4096];
+        bool keepAlive = true;
+        while (keepAlive) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    keepAlive = false;
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            if (!keepAlive) {
+                break;
+            }
+            std::string header = buffer.substr(0, headerEnd);
+            buffer.erase(0, headerEnd + 4);
+            keepAlive = header.find("Connection: close") == std::string::npos;
+
+            std::istringstream requestLine(header);
+            std::string method, target;
+            requestLine >> method >> target;
+            std::string symbol = queryParam(target, "symbol");
+
+            int current = ++inFlight;
+            int previous = maxInFlight.load();
+            while (current > previous && !maxInFlight.compare_exchange_weak(previous, current)) {
+            }
+            {
+                std::lock_guard<std::mutex> lock(logMutex);
+                double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - serverStart).count();
+                std::cout << "[STUB] " << t << "s " << method << " " << symbol << " (連線 #" << connectionId
+                          << "，開啟中 " << openConnections.load() << "，處理中 " << current
+                          << "，最多 " << maxInFlight.load() << ")" << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+
+            bool found = false;
+            std::string body = symbol.empty() ? "" : readFile(dataDir + "/stock_data_" + symbol + ".json", found);
+            if (!found) {
+                // Alpha Vantage 對無效代碼同樣回傳 200 與錯誤訊息
+                body = "{\n    \"Error Message\": \"Invalid API call. Unknown symbol: " + symbol + "\"\n}";
+            }
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(body.size()) + (keepAlive ? "\r\n" : "\r\nConnection: close\r\n") +
+                                   "\r\n" + body;
+            --inFlight;
+            if (!sendAll(fd, response)) {
+                break;
+            }
+        }
+        close(fd);
+        --openConnections;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    latencyMs = argc > 2 ? std::atoi(argv[2]) : 200;
+    dataDir = argc > 3 ? argv[3] : ".";
+
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (server < 0 || bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 128) != 0) {
+        std::cerr << "[ERROR] 無法監聽連接埠 " << port << std::endl;
+        return 1;
+    }
+    std::cout << "[LOG] 測試伺服器啟動: http://127.0.0.1:" << port << "/query，延遲 " << latencyMs << " ms，資料夾 " << dataDir << std::endl;
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client >= 0) {
+            std::thread(serveConnection, client).detach();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// CurlHandlePool.cpp
+#include "CurlHandlePool.h"
+#include <algorithm>
+#include <sstream>
+
+CurlHandlePool::CurlHandlePool(const std::string& caInfo, long timeoutSeconds, int maxConnections)
+    : caInfo_(caInfo), timeoutSeconds_(timeoutSeconds) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    multi_ = curl_multi_init();
+    share_ = curl_share_init();
+    if (multi_) {
+        // 每台主機的連線數不超過並行上限，讓請求排隊沿用既有連線而不是另開新連線
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(std::max(maxConnections, 1)));
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(std::max(maxConnections, 1)));
+    }
+    if (share_) {
+        // 所有 handle 都在同一條執行緒上由 multi 驅動，不需要 lock 函式
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+}
+
+CurlHandlePool::~CurlHandlePool() {
+    for (CURL* curl : all_) {
+        if (multi_) {
+            curl_multi_remove_handle(multi_, curl);
+        }
+        curl_easy_cleanup(curl);
+    }
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+    curl_global_cleanup();
+}
+
+CURL* CurlHandlePool::acquire() {
+    if (!idle_.empty()) {
+        CURL* curl = idle_.back();
+        idle_.pop_back();
+        return curl;
+    }
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return nullptr;
+    }
+    curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeoutSeconds_);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, 3600L);
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, ""); // 接受伺服器支援的任何壓縮格式
+    if (!caInfo_.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, caInfo_.c_str());
+    }
+    all_.push_back(curl);
+    created_++;
+    return curl;
+}
+
+void CurlHandlePool::release(CURL* curl) {
+    idle_.push_back(curl);
+}
+
+RequestTiming RequestTiming::fromHandle(CURL* curl) {
+    curl_off_t nameLookup = 0, connect = 0, appConnect = 0, startTransfer = 0, total = 0, bytes = 0;
+    long connects = 0;
+    RequestTiming timing;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appConnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &timing.status);
+
+    // curl 的各時間點皆自請求開始累計（微秒），相減得到各階段耗時；沿用連線時交握階段為 0
+    const double us = 1e-6;
+    curl_off_t handshakeEnd = std::max(connect, appConnect);
+    timing.dns = nameLookup * us;
+    timing.connect = std::max<curl_off_t>(connect - nameLookup, 0) * us;
+    timing.tls = appConnect > 0 ? std::max<curl_off_t>(appConnect - connect, 0) * us : 0.0;
+    timing.ttfb = std::max<curl_off_t>(startTransfer - handshakeEnd, 0) * us;
+    timing.transfer = std::max<curl_off_t>(total - startTransfer, 0) * us;
+    timing.total = total * us;
+    timing.reused = connects == 0;
+    timing.bytes = static_cast<double>(bytes);
+    return timing;
+}
+
+std::string RequestTiming::toJson(const std::string& symbol) const {
+    std::ostringstream out;
+    out << "{\"symbol\":\"" << symbol << "\",\"status\":" << status << ",\"bytes\":" << static_cast<long long>(bytes)
+        << ",\"reused\":" << (reused ? "true" : "false") << ",\"dns_ms\":" << dns * 1e3
+        << ",\"connect_ms\":" << connect * 1e3 << ",\"tls_ms\":" << tls * 1e3 << ",\"ttfb_ms\":" << ttfb * 1e3
+        << ",\"transfer_ms\":" << transfer * 1e3 << ",\"total_ms\":" << total * 1e3 << "}";
+    return out.str();
+}
@@ -0,0 +1,56 @@
+// CurlHandlePool.h
+#pragma once
+
+#include <curl/curl.h>
+#include <string>
+#include <vector>
+
+// CurlHandlePool 類別：一次執行期間共用的 curl 資源
+// easy handle 用完後放回池中重複使用（保留其連線與設定），
+// 所有 handle 透過 share 介面共用 DNS 快取、TLS session 與連線快取，
+// 對同一主機的後續請求可省去 DNS 查詢與 TCP/TLS 交握
+class CurlHandlePool {
+public:
+    CurlHandlePool(const std::string& caInfo, long timeoutSeconds, int maxConnections);
+    ~CurlHandlePool();
+
+    CurlHandlePool(const CurlHandlePool&) = delete;
+    CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+
+    // 初始化是否成功
+    bool valid() const { return multi_ != nullptr && share_ != nullptr; }
+
+    // 取得一個已設定好共用資源的 easy handle，沒有閒置 handle 時才建立新的
+    CURL* acquire();
+    // 歸還 handle；呼叫端需先自 multi 移除
+    void release(CURL* curl);
+
+    CURLM* multi() const { return multi_; }
+    size_t created() const { return created_; }
+
+private:
+    std::string caInfo_;
+    long timeoutSeconds_;
+    CURLM* multi_ = nullptr;
+    CURLSH* share_ = nullptr;
+    std::vector<CURL*> idle_;
+    std::vector<CURL*> all_;
+    size_t created_ = 0;
+};
+
+// 單一請求的耗時分解（秒），由 curl 的計時資訊換算
+struct RequestTiming {
+    double dns = 0.0;      // DNS 查詢
+    double connect = 0.0;  // TCP 連線
+    double tls = 0.0;      // TLS 交握
+    double ttfb = 0.0;     // 送出請求到收到第一個位元組
+    double transfer = 0.0; // 接收回應內容
+    double total = 0.0;
+    bool reused = false;   // 是否沿用既有連線
+    long status = 0;       // HTTP 狀態碼
+    double bytes = 0.0;    // 下載位元組數
+
+    static RequestTiming fromHandle(CURL* curl);
+    // 單行 JSON，供記錄檔或監控系統解析
+    std::string toJson(const std::string& symbol) const;
+};
@@ -0,0 +1,184 @@
+// FetchScheduler.cpp
+#include "FetchScheduler.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+using ordered_json = nlohmann::ordered_json;
+
+namespace {
+    // 公曆日期與日序互轉（1970-01-01 為 0）
+    long daysFromCivil(int y, int m, int d) {
+        y -= m <= 2;
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const int yoe = y - era * 400;
+        const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return static_cast<long>(era) * 146097 + doe - 719468;
+    }
+
+    // 解析 YYYY-MM-DD（允許後面接時間），失敗回傳 false
+    bool parseDate(const std::string& text, long& day) {
+        int y, m, d;
+        if (text.size() < 10 || std::sscanf(text.c_str(), "%4d-%2d-%2d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+            return false;
+        }
+        day = daysFromCivil(y, m, d);
+        return true;
+    }
+
+    // 1970-01-01 是週四：(day + 3) % 7 為 0..6 對應週一..週日
+    bool isWeekday(long day) {
+        return ((day % 7 + 7 + 3) % 7) < 5;
+    }
+}
+
+const char* fetchModeName(FetchMode mode) {
+    switch (mode) {
+    case FetchMode::Skip:
+        return "skip";
+    case FetchMode::Compact:
+        return "compact";
+    default:
+        return "full";
+    }
+}
+
+FetchScheduler::FetchScheduler(const std::string& dataDir, int compactMaxDays)
+    : dataDir_(dataDir), compactMaxDays_(compactMaxDays) {}
+
+std::string FetchScheduler::latestTradingDay(std::time_t now) {
+    // 美東標準時間為 UTC-5；夏令時間的一小時誤差只影響午夜前後的判斷
+    std::time_t eastern = now - 5 * 3600;
+    std::tm parts = *std::gmtime(&eastern);
+    long day = daysFromCivil(parts.tm_year + 1900, parts.tm_mon + 1, parts.tm_mday);
+    while (!isWeekday(day)) {
+        day--;
+    }
+    // 日序轉回日期字串
+    long z = day + 719468;
+    const long era = (z >= 0 ? z : z - 146096) / 146097;
+    const long doe = z - era * 146097;
+    const long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long mp = (5 * doy + 2) / 153;
+    const long d = doy - (153 * mp + 2) / 5 + 1;
+    const long m = mp + (mp < 10 ? 3 : -9);
+    const long y = yoe + era * 400 + (m <= 2);
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", static_cast<int>(y), static_cast<int>(m), static_cast<int>(d));
+    return buffer;
+}
+
+std::string FetchScheduler::readLastRefreshed(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return "";
+    }
+    // Meta Data 位於檔案開頭，讀前 4KB 即可，不必解析整份歷史
+    std::string head(4096, '\0');
+    in.read(&head[0], static_cast<std::streamsize>(head.size()));
+    head.resize(static_cast<size_t>(in.gcount()));
+    const std::string key = "\"3. Last Refreshed\"";
+    size_t pos = head.find(key);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    size_t open = head.find('"', head.find(':', pos + key.size()));
+    size_t close = open == std::string::npos ? std::string::npos : head.find('"', open + 1);
+    if (close == std::string::npos) {
+        return "";
+    }
+    return head.substr(open + 1, close - open - 1).substr(0, 10);
+}
+
+FetchPlan FetchScheduler::plan(const std::string& symbol, const std::string& latestDay) const {
+    FetchPlan result;
+    result.symbol = symbol;
+    result.lastRefreshed = readLastRefreshed(dataDir_ + "/stock_data_" + symbol + ".json");
+    long cached, latest;
+    if (result.lastRefreshed.empty() || !parseDate(result.lastRefreshed, cached) || !parseDate(latestDay, latest)) {
+        result.mode = FetchMode::Full;
+        return result;
+    }
+    for (long day = cached + 1; day <= latest; ++day) {
+        result.missingDays += isWeekday(day) ? 1 : 0;
+    }
+    if (result.missingDays == 0) {
+        result.mode = FetchMode::Skip;
+    } else {
+        result.mode = result.missingDays <= compactMaxDays_ ? FetchMode::Compact : FetchMode::Full;
+    }
+    return result;
+}
+
+std::vector<FetchPlan> FetchScheduler::planAll(const std::vector<std::string>& symbols, const std::string& latestDay) const {
+    std::vector<FetchPlan> plans;
+    plans.reserve(symbols.size());
+    for (const std::string& symbol : symbols) {
+        plans.push_back(plan(symbol, latestDay));
+    }
+    return plans;
+}
+
+MergeResult FetchScheduler::mergeCompact(const std::string& existingJson, const std::string& compactJson,
+                                         std::string& merged, std::string& error) {
+    json incoming = json::parse(compactJson, nullptr, false);
+    if (incoming.is_discarded() || !incoming.contains("Time Series (Daily)") || incoming["Time Series (Daily)"].empty()) {
+        // API 以 200 回傳錯誤時，訊息放在這幾個鍵中
+        error = "回應不是日 K 資料";
+        for (const char* key : {"Note", "Information", "Error Message"}) {
+            if (!incoming.is_discarded() && incoming.contains(key) && incoming[key].is_string()) {
+                error += ": " + incoming[key].get<std::string>();
+            }
+        }
+        return MergeResult::Invalid;
+    }
+    json existing = json::parse(existingJson, nullptr, false);
+    if (existing.is_discarded() || !existing.contains("Time Series (Daily)") || existing["Time Series (Daily)"].empty()) {
+        error = "既有快取無法解析";
+        return MergeResult::Invalid;
+    }
+
+    // json 物件依鍵排序，第一個鍵即最早的日期
+    const json& oldSeries = existing["Time Series (Daily)"];
+    const json& newSeries = incoming["Time Series (Daily)"];
+    std::string newestCached = std::prev(oldSeries.end()).key();
+    std::string oldestIncoming = newSeries.begin().key();
+    if (oldestIncoming > newestCached) {
+        error = "compact 回應最早為 " + oldestIncoming + "，快取最新為 " + newestCached + "，中間有缺口";
+        return MergeResult::Gap;
+    }
+
+    std::map<std::string, json> days;
+    for (auto it = oldSeries.begin(); it != oldSeries.end(); ++it) {
+        days[it.key()] = it.value();
+    }
+    for (auto it = newSeries.begin(); it != newSeries.end(); ++it) {
+        days[it.key()] = it.value();
+    }
+
+    ordered_json output;
+    output["Meta Data"] = ordered_json::object();
+    const json& meta = incoming.contains("Meta Data") ? incoming["Meta Data"] : existing["Meta Data"];
+    for (auto it = meta.begin(); it != meta.end(); ++it) {
+        output["Meta Data"][it.key()] = it.value();
+    }
+    if (existing.contains("Meta Data") && existing["Meta Data"].contains("4. Output Size")) {
+        output["Meta Data"]["4. Output Size"] = existing["Meta Data"]["4. Output Size"];
+    }
+    ordered_json series = ordered_json::object();
+    for (auto it = days.rbegin(); it != days.rend(); ++it) {
+        ordered_json fields = ordered_json::object();
+        for (auto field = it->second.begin(); field != it->second.end(); ++field) {
+            fields[field.key()] = field.value();
+        }
+        series[it->first] = fields;
+    }
+    output["Time Series (Daily)"] = std::move(series);
+    merged = output.dump(4);
+    return MergeResult::Merged;
+}
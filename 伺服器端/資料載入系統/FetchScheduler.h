@@ -0,0 +1,55 @@
+// FetchScheduler.h
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+// 單一代碼的抓取方式
+enum class FetchMode {
+    Skip,    // 快取已是最新交易日
+    Compact, // 只缺少少數交易日：抓最近 100 筆再合併進既有歷史
+    Full     // 新代碼、快取無法讀取或缺口超過 compact 範圍：抓完整歷史
+};
+
+const char* fetchModeName(FetchMode mode);
+
+struct FetchPlan {
+    std::string symbol;
+    FetchMode mode = FetchMode::Full;
+    std::string lastRefreshed; // 快取中的 "3. Last Refreshed"，沒有快取時為空字串
+    int missingDays = 0;       // 快取之後到最新交易日之間缺少的交易日數（僅計週一至週五）
+};
+
+// compact 回應合併的結果
+enum class MergeResult {
+    Merged,
+    Gap,    // compact 回應與既有歷史沒有重疊，需要改抓完整歷史
+    Invalid // 回應不是日 K 資料（例如超出配額的提示訊息）或快取無法解析
+};
+
+// FetchScheduler 類別：依快取檔的最後更新日決定每個代碼要略過、抓 compact 或抓 full，
+// 並把 compact 回應合併進既有的完整歷史
+class FetchScheduler {
+public:
+    // dataDir 為 stock_data_<代碼>.json 所在資料夾；缺少的交易日不超過 compactMaxDays 時使用 compact
+    FetchScheduler(const std::string& dataDir, int compactMaxDays = 90);
+
+    // 以美東時間推算最近一個交易日（週末退回週五，不考慮國定假日），格式 YYYY-MM-DD
+    static std::string latestTradingDay(std::time_t now = std::time(nullptr));
+
+    FetchPlan plan(const std::string& symbol, const std::string& latestDay) const;
+    std::vector<FetchPlan> planAll(const std::vector<std::string>& symbols, const std::string& latestDay) const;
+
+    // 只讀取檔案開頭取出 "3. Last Refreshed" 的日期，找不到時回傳空字串
+    static std::string readLastRefreshed(const std::string& path);
+
+    // 把 compact 回應合併進既有歷史：同一天以新資料為準，Meta Data 取新回應但保留既有的 "4. Output Size"，
+    // 日期依 API 的慣例降序輸出；失敗時 error 說明原因
+    static MergeResult mergeCompact(const std::string& existingJson, const std::string& compactJson,
+                                    std::string& merged, std::string& error);
+
+private:
+    std::string dataDir_;
+    int compactMaxDays_;
+};
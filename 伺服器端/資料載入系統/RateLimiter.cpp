@@ -0,0 +1,42 @@
+// RateLimiter.cpp
+#include "RateLimiter.h"
+#include <algorithm>
+
+// 建構子：桶子一開始是滿的，第一批請求可立即送出
+TokenBucket::TokenBucket(double requestsPerMinute, double burst)
+    : ratePerSecond_(requestsPerMinute / 60.0),
+      capacity_(std::max(burst, 1.0)),
+      tokens_(std::max(burst, 1.0)),
+      last_(Clock::now()) {}
+
+void TokenBucket::refill(Clock::time_point now) {
+    if (now > last_) {
+        double elapsed = std::chrono::duration<double>(now - last_).count();
+        tokens_ = std::min(capacity_, tokens_ + elapsed * ratePerSecond_);
+        last_ = now;
+    }
+}
+
+bool TokenBucket::tryAcquire(Clock::time_point now) {
+    if (ratePerSecond_ <= 0.0) {
+        return true;
+    }
+    refill(now);
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+}
+
+TokenBucket::Clock::duration TokenBucket::waitTime(Clock::time_point now) {
+    if (ratePerSecond_ <= 0.0) {
+        return Clock::duration::zero();
+    }
+    refill(now);
+    if (tokens_ >= 1.0) {
+        return Clock::duration::zero();
+    }
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>((1.0 - tokens_) / ratePerSecond_));
+}
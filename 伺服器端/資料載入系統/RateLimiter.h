@@ -0,0 +1,29 @@
+// RateLimiter.h
+#pragma once
+
+#include <chrono>
+
+// TokenBucket 類別：權杖桶速率限制器
+// 權杖以 requestsPerMinute / 60 的速率補充，最多累積 burst 個；每個請求消耗一個權杖
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // requestsPerMinute <= 0 表示不限速
+    TokenBucket(double requestsPerMinute, double burst = 1.0);
+
+    // 有權杖時取用並回傳 true
+    bool tryAcquire(Clock::time_point now = Clock::now());
+
+    // 距離下一個權杖可用的時間，目前已有權杖時為 0
+    Clock::duration waitTime(Clock::time_point now = Clock::now());
+
+private:
+    double ratePerSecond_; // 每秒補充的權杖數
+    double capacity_;      // 桶子容量（允許的突發請求數）
+    double tokens_;        // 目前的權杖數
+    Clock::time_point last_;
+
+    // 依經過時間補充權杖
+    void refill(Clock::time_point now);
+};
@@ -0,0 +1,139 @@
+// ShardStatus.cpp
+#include "ShardStatus.h"
+#include <ctime>
+#include <filesystem>
+#include <sstream>
+#include <cstdio>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+const size_t ShardStatus::RECORD_SIZE;
+
+ShardStatus::ShardStatus(const std::string& path, uint32_t shardIndex, uint32_t shardCount)
+    : path_(path), shardIndex_(shardIndex), shardCount_(shardCount) {
+    // 之前以較多分片執行時留下的紀錄：本次各行程只會寫入前 shardCount 筆，其餘截掉
+    std::error_code ec;
+    uint64_t used = static_cast<uint64_t>(shardCount_) * RECORD_SIZE;
+    if (std::filesystem::file_size(path_, ec) > used && !ec) {
+        std::filesystem::resize_file(path_, used, ec);
+    }
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file_.is_open()) {
+        // 檔案不存在時以附加模式建立，避免清掉其他行程已寫入的內容
+        std::ofstream(path_, std::ios::app | std::ios::binary);
+        file_.clear();
+        file_.open(path_, std::ios::in | std::ios::out | std::ios::binary);
+    }
+}
+
+void ShardStatus::start(size_t total, size_t skipped) {
+    total_ = total;
+    skipped_ = skipped;
+    ok_ = failed_ = 0;
+    write("running");
+}
+
+void ShardStatus::update(const std::string& symbol, bool ok) {
+    (ok ? ok_ : failed_)++;
+    last_ = symbol;
+    write("running");
+}
+
+void ShardStatus::finish() {
+    write("done");
+}
+
+void ShardStatus::write(const char* state) {
+    if (!file_) {
+        return;
+    }
+    char updated[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(updated, sizeof(updated), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::ostringstream record;
+    record << "shard=" << shardIndex_ << "/" << shardCount_ << " state=" << state << " done=" << (ok_ + failed_) << "/" << total_
+           << " ok=" << ok_ << " failed=" << failed_ << " skipped=" << skipped_ << " pid=" << getpid()
+           << " updated=" << updated << " last=" << last_;
+    std::string line = record.str().substr(0, RECORD_SIZE - 1);
+    line.resize(RECORD_SIZE - 1, ' ');
+    line += '\n';
+    file_.seekp(static_cast<std::streamoff>(shardIndex_ * RECORD_SIZE));
+    file_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    file_.flush();
+}
+
+bool ShardStatus::summarize(const std::string& path, std::ostream& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::ostringstream content;
+    content << in.rdbuf();
+    std::string data = content.str();
+
+    // 依位置取出每筆紀錄；尚未寫入的分片位置在某些平台上是補零的空洞，不以換行分割以免與下一筆黏在一起
+    struct Record {
+        std::string line, updated;
+        unsigned index = 0, count = 0;
+    };
+    std::vector<Record> records;
+    std::string latest;
+    unsigned currentCount = 0;
+    for (size_t offset = 0; offset < data.size(); offset += RECORD_SIZE) {
+        Record record;
+        record.line = data.substr(offset, RECORD_SIZE);
+        record.line = record.line.substr(0, record.line.find_last_not_of(" \n") + 1);
+        if (record.line.compare(0, 6, "shard=") != 0 ||
+            std::sscanf(record.line.c_str(), "shard=%u/%u", &record.index, &record.count) != 2 ||
+            record.index != offset / RECORD_SIZE) {
+            continue;
+        }
+        size_t at = record.line.find(" updated=");
+        if (at != std::string::npos) {
+            record.updated = record.line.substr(at + 9, record.line.find(' ', at + 9) - at - 9);
+        }
+        // 以最近更新的紀錄為準決定目前的分片總數（時間為 UTC ISO 格式，可直接比較字串）
+        if (records.empty() || record.updated > latest) {
+            latest = record.updated;
+            currentCount = record.count;
+        }
+        records.push_back(record);
+    }
+
+    size_t shards = 0, stale = 0, running = 0, done = 0, total = 0, ok = 0, failed = 0, skipped = 0;
+    for (const Record& record : records) {
+        if (record.count != currentCount || record.index >= currentCount) {
+            stale++;
+            continue;
+        }
+        out << record.line << "\n";
+        std::istringstream fields(record.line);
+        std::string field;
+        size_t finished = 0, requests = 0, count = 0;
+        while (fields >> field) {
+            size_t eq = field.find('=');
+            std::string key = field.substr(0, eq), value = field.substr(eq + 1);
+            if (key == "state") {
+                (value == "done" ? done : running)++;
+            } else if (key == "done" && std::sscanf(value.c_str(), "%zu/%zu", &finished, &requests) == 2) {
+                total += requests;
+            } else if ((key == "ok" || key == "failed" || key == "skipped") && std::sscanf(value.c_str(), "%zu", &count) == 1) {
+                (key == "ok" ? ok : key == "failed" ? failed : skipped) += count;
+            }
+        }
+        shards++;
+    }
+    out << "分片 " << shards << "/" << currentCount << "（完成 " << done << "，進行中 " << running << "），請求 " << (ok + failed) << "/" << total
+        << "，成功 " << ok << "，失敗 " << failed << "，略過 " << skipped;
+    if (stale > 0) {
+        out << "；忽略過期紀錄 " << stale << " 筆";
+    }
+    out << std::endl;
+    return true;
+}
@@ -0,0 +1,43 @@
+// ShardStatus.h
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+// ShardStatus 類別：多個抓取行程共用的進度檔。
+// 每個分片固定佔用一行（RECORD_SIZE 位元組，位置為 分片編號 × RECORD_SIZE），
+// 各行程只覆寫自己的那一行，因此不需要檔案鎖也不會互相覆蓋；任何時候 cat 該檔即可看到所有分片的進度。
+// 開啟時截掉 分片總數 × RECORD_SIZE 之後的內容，之前以較多分片執行留下的紀錄不會被算進來
+class ShardStatus {
+public:
+    static const size_t RECORD_SIZE = 160;
+
+    ShardStatus(const std::string& path, uint32_t shardIndex, uint32_t shardCount);
+
+    // 進度檔是否可寫入
+    bool valid() const { return static_cast<bool>(file_); }
+
+    // 開始抓取：total 為本分片要送出的請求數，skipped 為排程時判定已是最新而略過的代碼數
+    void start(size_t total, size_t skipped);
+
+    // 一個代碼處理完成
+    void update(const std::string& symbol, bool ok);
+
+    // 本分片結束
+    void finish();
+
+    // 彙總進度檔中所有分片的狀態：依位置逐筆讀取固定長度的紀錄，略過尚未寫入的空洞，
+    // 並只採計與最近更新的紀錄分片總數相同、且位置相符的紀錄
+    static bool summarize(const std::string& path, std::ostream& out);
+
+private:
+    std::string path_;
+    uint32_t shardIndex_, shardCount_;
+    std::fstream file_;
+    size_t total_ = 0, skipped_ = 0, ok_ = 0, failed_ = 0;
+    std::string last_;
+
+    void write(const char* state);
+};
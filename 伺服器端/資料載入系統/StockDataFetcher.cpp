@@ -1,14 +1,106 @@
 // StockDataFetcher.cpp
 #include "StockDataFetcher.h"
+#include "RateLimiter.h"
+#include "CurlHandlePool.h"
+#include "FetchScheduler.h"
 #include <iostream>
+#include <sstream>
 #include <fstream>
 #include <curl/curl.h>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
-// 建構子：使用 API 金鑰初始化
-StockDataFetcher::StockDataFetcher(const std::string& apiKey)
-    : apiKey_(apiKey) {}
+namespace {
+    // 一個進行中的請求：回應內容寫入 body（串流模式下交給 stream，需要存檔時才另外累積），
+    // easy handle 以 CURLOPT_PRIVATE 指回此結構
+    struct Transfer {
+        FetchRequest request;
+        std::string symbol;
+        std::string body;
+        CURL* curl = nullptr;
+        std::chrono::steady_clock::time_point started;
+        std::unique_ptr<ResponseStream> stream;
+        bool keepBody = true;
+    };
+
+    // 串流模式的寫入回呼：資料片段直接交給處理者，回傳值不等於片段長度時 curl 會中止該請求
+    size_t streamCallback(char* contents, size_t size, size_t nmemb, void* userdata) {
+        Transfer* transfer = static_cast<Transfer*>(userdata);
+        size_t totalSize = size * nmemb;
+        if (transfer->keepBody) {
+            transfer->body.append(contents, totalSize);
+        }
+        return transfer->stream->write(contents, totalSize) ? totalSize : 0;
+    }
+
+    // ArchiveWriter 類別：背景執行緒依序寫出原始 JSON，close() 或解構時等待所有檔案寫完
+    class ArchiveWriter {
+    public:
+        ArchiveWriter() : worker_(&ArchiveWriter::run, this) {}
+
+        ~ArchiveWriter() { close(); }
+
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closing_ = true;
+            }
+            ready_.notify_one();
+            if (worker_.joinable()) {
+                worker_.join();
+            }
+        }
+
+        void enqueue(const std::string& path, std::string data) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.emplace_back(path, std::move(data));
+            }
+            ready_.notify_one();
+        }
+
+        size_t written() const { return written_; }
+        size_t failed() const { return failed_; }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                ready_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                std::pair<std::string, std::string> item = std::move(queue_.front());
+                queue_.pop_front();
+                lock.unlock();
+                std::ofstream outFile(item.first, std::ios::binary);
+                outFile << item.second;
+                bool ok = static_cast<bool>(outFile);
+                lock.lock();
+                (ok ? written_ : failed_)++;
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<std::pair<std::string, std::string>> queue_;
+        bool closing_ = false;
+        size_t written_ = 0, failed_ = 0;
+        std::thread worker_; // 最後初始化，確保其他成員已建立
+    };
+}
+
+// 建構子：使用 API 金鑰與抓取設定初始化
+StockDataFetcher::StockDataFetcher(const std::string& apiKey, const FetchOptions& options)
+    : apiKey_(apiKey), options_(options) {
+    options_.maxConcurrency = std::max(options_.maxConcurrency, 1);
+}
+
+StockDataFetcher::~StockDataFetcher() = default;
 
 // 靜態回呼函數：libcurl 將接收到的資料寫入字串中
 size_t StockDataFetcher::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
@@ -17,61 +109,247 @@ size_t StockDataFetcher::WriteCallback(void* contents, size_t size, size_t nmemb
     return totalSize;
 }
 
-// 根據股票代號從 Alpha Vantage API 抓取股票資料
-std::string StockDataFetcher::getStockData(const std::string& symbol) {
-    std::cout << "[LOG] 準備連線至 Alpha Vantage API，代碼: " << symbol << std::endl;
-    std::string url = "https://www.alphavantage.co/query?function=TIME_SERIES_DAILY&symbol=" + symbol + "&apikey=" + apiKey_;
-    CURL* curl;
-    CURLcode res;
-    std::string readBuffer;
-
-    curl = curl_easy_init();
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-        curl_easy_setopt(curl, CURLOPT_CAINFO, "cacert.pem");
-
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            std::cerr << "[ERROR] curl_easy_perform() 執行失敗，代碼: " << symbol << ", 錯誤訊息: " << curl_easy_strerror(res) << std::endl;
-        } else {
-            std::cout << "[LOG] 成功獲取資料: " << symbol << std::endl;
-        }
-        curl_easy_cleanup(curl);
-    } else {
-        std::cerr << "[ERROR] 初始化 CURL 失敗！" << std::endl;
-    }
-    return readBuffer;
+std::string StockDataFetcher::requestUrl(const FetchRequest& request) const {
+    return options_.baseUrl + "?function=TIME_SERIES_DAILY&symbol=" + request.symbol +
+           "&outputsize=" + (request.size == OutputSize::Full ? "full" : "compact") + "&apikey=" + apiKey_;
+}
+
+void StockDataFetcher::setResponseStream(ResponseStreamFactory factory) {
+    streamFactory_ = std::move(factory);
+}
+
+void StockDataFetcher::setProgressCallback(ProgressCallback callback) {
+    progress_ = std::move(callback);
+}
+
+std::string StockDataFetcher::jsonPath(const std::string& symbol) const {
+    return options_.outputDir + "/stock_data_" + symbol + ".json";
 }
 
 // 將原始 JSON 資料儲存到本地檔案
-void StockDataFetcher::saveJson(const std::string& symbol, const std::string& jsonData) {
-    std::string filename = "stock_data_" + symbol + ".json";
+bool StockDataFetcher::saveJson(const std::string& symbol, const std::string& jsonData) {
+    std::string filename = jsonPath(symbol);
     std::ofstream outFile(filename);
     if (outFile.is_open()) {
         outFile << jsonData;
         outFile.close();
         std::cout << "[LOG] JSON 資料成功儲存至: " << filename << std::endl;
-    } else {
-        std::cerr << "[ERROR] 無法儲存 JSON 至 " << filename << std::endl;
+        return true;
     }
+    std::cerr << "[ERROR] 無法儲存 JSON 至 " << filename << std::endl;
+    return false;
 }
 
-// 批次抓取多個股票代碼的資料並儲存成 JSON
-void StockDataFetcher::fetchAndSaveAll(const std::vector<std::string>& symbols) {
-    for (size_t i = 0; i < symbols.size(); ++i) {
-        std::cout << "[LOG] 開始處理股票代碼: " << symbols[i] << std::endl;
-        std::string jsonData = getStockData(symbols[i]);
+// 將 compact 回應與既有檔案合併
+bool StockDataFetcher::mergeWithCache(const std::string& symbol, const std::string& jsonData, std::string& merged, bool& needFull) {
+    needFull = false;
+    std::ifstream inFile(jsonPath(symbol), std::ios::binary);
+    if (!inFile.is_open()) {
+        // 排程後檔案被移除：沒有可合併的歷史，改抓完整資料
+        needFull = true;
+        return false;
+    }
+    std::ostringstream existing;
+    existing << inFile.rdbuf();
+    inFile.close();
+
+    std::string error;
+    switch (FetchScheduler::mergeCompact(existing.str(), jsonData, merged, error)) {
+    case MergeResult::Merged:
+        return true;
+    case MergeResult::Gap:
+        std::cout << "[LOG] " << symbol << " " << error << "，改抓完整歷史" << std::endl;
+        needFull = true;
+        return false;
+    default:
+        std::cerr << "[ERROR] 無法合併 " << symbol << "：" << error << std::endl;
+        return false;
+    }
+}
+
+// 舊介面：每個代碼以 API 預設的 compact 抓取並直接覆蓋
+size_t StockDataFetcher::fetchAndSaveAll(const std::vector<std::string>& symbols) {
+    std::vector<FetchRequest> requests;
+    requests.reserve(symbols.size());
+    for (const std::string& symbol : symbols) {
+        requests.push_back({symbol, OutputSize::Compact, false});
+    }
+    return fetchAndSaveAll(requests);
+}
+
+// 批次抓取多個股票代碼的資料並儲存成 JSON：
+// 同時進行的請求不超過 maxConcurrency，新請求只在權杖桶有權杖時送出，
+// 因此吞吐量直接對應方案的每分鐘配額，而不是固定間隔等待
+size_t StockDataFetcher::fetchAndSaveAll(const std::vector<FetchRequest>& requests) {
+    if (!pool_) {
+        pool_.reset(new CurlHandlePool(options_.caInfo, options_.timeoutSeconds, options_.maxConcurrency));
+    }
+    if (!pool_->valid()) {
+        std::cerr << "[ERROR] 初始化 CURL multi 失敗！" << std::endl;
+        return 0;
+    }
+    CURLM* multi = pool_->multi();
+    std::ofstream metrics;
+    if (!options_.metricsFile.empty()) {
+        metrics.open(options_.metricsFile, std::ios::app);
+        if (!metrics) {
+            std::cerr << "[ERROR] 無法寫入請求記錄 " << options_.metricsFile << std::endl;
+        }
+    }
 
-        // 儲存原始 JSON 檔案
-        saveJson(symbols[i], jsonData);
+    bool streaming = static_cast<bool>(streamFactory_);
+    std::unique_ptr<ArchiveWriter> archiver;
+    if (streaming && options_.archive) {
+        archiver.reset(new ArchiveWriter());
+    }
+
+    TokenBucket limiter(options_.requestsPerMinute, options_.burst);
+    std::deque<FetchRequest> pending(requests.begin(), requests.end());
+    std::deque<Transfer> transfers; // deque 尾端加入不移動既有元素，確保 CURLOPT_PRIVATE 指標不失效
+    size_t active = 0, saved = 0, reused = 0, refetched = 0;
+    double handshakeSeconds = 0.0;
+    auto runStart = std::chrono::steady_clock::now();
+
+    while (!pending.empty() || active > 0) {
+        // 在並行上限與速率限制內盡量送出新請求
+        while (!pending.empty() && active < static_cast<size_t>(options_.maxConcurrency) && limiter.tryAcquire()) {
+            transfers.emplace_back();
+            Transfer& transfer = transfers.back();
+            transfer.request = pending.front();
+            transfer.symbol = transfer.request.symbol;
+            pending.pop_front();
+            transfer.curl = pool_->acquire();
+            if (!transfer.curl) {
+                std::cerr << "[ERROR] 初始化 CURL 失敗，代碼: " << transfer.symbol << std::endl;
+                if (progress_) {
+                    progress_(transfer.symbol, false);
+                }
+                continue;
+            }
+            std::string url = requestUrl(transfer.request);
+            curl_easy_setopt(transfer.curl, CURLOPT_URL, url.c_str());
+            if (streaming && !transfer.request.merge) {
+                transfer.stream = streamFactory_(transfer.symbol);
+                transfer.keepBody = options_.archive;
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, streamCallback);
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer);
+            } else {
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer.body);
+            }
+            curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+            transfer.started = std::chrono::steady_clock::now();
+            curl_multi_add_handle(multi, transfer.curl);
+            active++;
+            std::cout << "[LOG] 開始處理股票代碼: " << transfer.symbol << std::endl;
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        // 收取已完成的請求
+        CURLMsg* msg;
+        int queued = 0;
+        while ((msg = curl_multi_info_read(multi, &queued))) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+            RequestTiming timing = RequestTiming::fromHandle(msg->easy_handle);
+            reused += timing.reused ? 1 : 0;
+            handshakeSeconds += timing.dns + timing.connect + timing.tls;
+            std::string metric = timing.toJson(transfer->symbol);
+            std::cout << "[METRIC] " << metric << std::endl;
+            if (metrics) {
+                metrics << metric << "\n";
+            }
+            bool ok = false;
+            if (msg->data.result != CURLE_OK) {
+                std::cerr << "[ERROR] 請求失敗，代碼: " << transfer->symbol << ", 錯誤訊息: " << curl_easy_strerror(msg->data.result) << std::endl;
+            } else if (timing.status != 200) {
+                std::cerr << "[ERROR] HTTP 狀態 " << timing.status << "，代碼: " << transfer->symbol << std::endl;
+            } else {
+                std::cout << "[LOG] 成功獲取資料: " << transfer->symbol << " (" << timing.total << " 秒)" << std::endl;
+                ok = true;
+            }
+            size_t savedBefore = saved;
+            bool requeued = false;
+            if (transfer->stream) {
+                // 串流模式：內容已在下載時處理完，只有處理成功的回應才存檔，避免錯誤訊息覆蓋既有資料
+                bool handled = transfer->stream->finish(ok);
+                transfer->stream.reset();
+                if (handled) {
+                    saved++;
+                    if (archiver) {
+                        archiver->enqueue(jsonPath(transfer->symbol), std::move(transfer->body));
+                    }
+                } else if (ok) {
+                    std::cerr << "[ERROR] 回應內容處理失敗，代碼: " << transfer->symbol << std::endl;
+                }
+            } else if (ok && transfer->body.find("\"Time Series (Daily)\"") == std::string::npos) {
+                // API 超出配額或代碼錯誤時同樣回傳 200，不以錯誤訊息覆蓋既有資料
+                std::cerr << "[ERROR] 回應不含日 K 資料，未儲存，代碼: " << transfer->symbol << std::endl;
+            } else if (ok && transfer->request.merge) {
+                bool needFull = false;
+                std::string merged;
+                if (!mergeWithCache(transfer->symbol, transfer->body, merged, needFull)) {
+                    if (needFull) {
+                        pending.push_front({transfer->symbol, OutputSize::Full, false});
+                        refetched++;
+                        requeued = true;
+                    }
+                } else if (streaming) {
+                    // 串流模式：合併後的完整歷史一次交給處理者，處理成功才存檔
+                    std::unique_ptr<ResponseStream> stream = streamFactory_(transfer->symbol);
+                    bool written = stream->write(merged.data(), merged.size());
+                    if (stream->finish(written)) {
+                        saved++;
+                        if (archiver) {
+                            archiver->enqueue(jsonPath(transfer->symbol), std::move(merged));
+                        }
+                    } else {
+                        std::cerr << "[ERROR] 回應內容處理失敗，代碼: " << transfer->symbol << std::endl;
+                    }
+                } else {
+                    saved += saveJson(transfer->symbol, merged) ? 1 : 0;
+                }
+            } else if (ok) {
+                saved += saveJson(transfer->symbol, transfer->body) ? 1 : 0;
+            }
+            if (progress_ && !requeued) {
+                progress_(transfer->symbol, saved > savedBefore);
+            }
+            CURL* curl = msg->easy_handle;
+            curl_multi_remove_handle(multi, curl);
+            pool_->release(curl);
+            transfer->curl = nullptr;
+            std::string().swap(transfer->body);
+            active--;
+        }
+
+        // 等待網路事件，或等到下一個權杖可用時再送出新請求
+        long waitMs = 1000;
+        if (!pending.empty() && active < static_cast<size_t>(options_.maxConcurrency)) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(limiter.waitTime());
+            waitMs = std::min<long>(waitMs, static_cast<long>(wait.count()) + 1);
+        }
+        if (active > 0) {
+            curl_multi_poll(multi, nullptr, 0, static_cast<int>(waitMs), nullptr);
+        } else if (!pending.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+        }
+    }
 
-        // 每次 API 請求間隔 12 秒，避免超出速率限制
-        if (i < symbols.size() - 1) {
-            std::cout << "[LOG] 等待 12 秒以符合 API 速率限制..." << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(12));
+    if (archiver) {
+        archiver->close(); // 等待背景寫檔完成
+        std::cout << "[LOG] 原始 JSON 已存檔 " << archiver->written() << " 個至: " << options_.outputDir << std::endl;
+        if (archiver->failed() > 0) {
+            std::cerr << "[ERROR] " << archiver->failed() << " 個原始 JSON 存檔失敗" << std::endl;
         }
     }
-    std::cout << "[LOG] 所有股票資料處理完成！" << std::endl;
-}
\ No newline at end of file
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    std::cout << "[LOG] 所有股票資料處理完成！成功 " << saved << "/" << requests.size() << "，改抓完整歷史 " << refetched << " 個，耗時 " << elapsed << " 秒，"
+              << "沿用連線 " << reused << " 次，交握累計 " << handshakeSeconds << " 秒，handle 數 " << pool_->created() << std::endl;
+    return saved;
+}
@@ -1,27 +1,100 @@
 // StockDataFetcher.h
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+class CurlHandlePool;
+
+// 抓取設定：API 位址、速率限制與同時連線數
+struct FetchOptions {
+    std::string baseUrl = "https://www.alphavantage.co/query"; // 可改指向本機測試伺服器
+    std::string caInfo = "cacert.pem"; // 空字串表示使用系統預設憑證
+    std::string outputDir = ".";       // stock_data_<代碼>.json 的輸出資料夾
+    double requestsPerMinute = 5.0;    // 方案每分鐘可用的請求數，<= 0 表示不限速
+    double burst = 1.0;                // 允許連續送出的請求數
+    int maxConcurrency = 1;            // 同時進行中的請求上限
+    long timeoutSeconds = 60;          // 單一請求逾時秒數
+    std::string metricsFile;           // 每個請求的耗時分解以 JSON lines 附加至此檔，空字串表示只輸出到畫面
+    bool archive = true;               // 串流模式下是否另存原始 JSON（由背景執行緒寫檔，不阻塞下載）
+};
+
+// 串流模式下單一請求的回應處理者：下載中的資料片段一到達就交給 write，不先累積成完整字串
+class ResponseStream {
+public:
+    virtual ~ResponseStream() = default;
+
+    // 回傳 false 時中止該請求
+    virtual bool write(const char* data, size_t size) = 0;
+
+    // 傳輸結束時呼叫一次；ok 為 false 表示傳輸失敗或 HTTP 狀態不是 200，回傳是否處理成功
+    virtual bool finish(bool ok) = 0;
+};
+
+// Alpha Vantage 的 outputsize：compact 為最近 100 個交易日，full 為完整歷史
+enum class OutputSize {
+    Compact,
+    Full
+};
+
+// 單一代碼的抓取請求
+struct FetchRequest {
+    std::string symbol;
+    OutputSize size = OutputSize::Compact;
+    bool merge = false; // 將 compact 回應合併進既有的 stock_data_<代碼>.json，而不是直接覆蓋；
+                        // 串流模式下此請求不邊下載邊處理，合併出完整歷史後才交給處理者並存檔
+};
+
+// 依股票代碼建立回應處理者
+using ResponseStreamFactory = std::function<std::unique_ptr<ResponseStream>(const std::string& symbol)>;
+
+// 每個請求得到最終結果時呼叫（改抓完整歷史的代碼只在重抓結束後呼叫一次）
+using ProgressCallback = std::function<void(const std::string& symbol, bool ok)>;
+
 // StockDataFetcher 類別：負責從 Alpha Vantage API 抓取股票資料並儲存成 JSON
 class StockDataFetcher {
 public:
-    // 建構子：初始化 API 金鑰
-    StockDataFetcher(const std::string& apiKey);
+    // 建構子：初始化 API 金鑰與抓取設定
+    StockDataFetcher(const std::string& apiKey, const FetchOptions& options = FetchOptions());
+    ~StockDataFetcher();
+
+    // 抓取並儲存多個股票代碼的資料：以 curl multi 同時進行多個請求，
+    // 送出時機由權杖桶限速，回傳成功儲存（串流模式下為成功處理）的代碼數。
+    // 同一個物件的多次呼叫共用連線池，連線與 TLS session 在整個執行期間重複使用
+    size_t fetchAndSaveAll(const std::vector<std::string>& symbols);
 
-    // 抓取並儲存多個股票代碼的資料
-    void fetchAndSaveAll(const std::vector<std::string>& symbols);
+    // 同上，但每個代碼可指定 outputsize 與是否合併。合併時若 compact 回應與既有歷史之間有缺口，
+    // 該代碼會自動改以 full 重新排入佇列；回應不是日 K 資料時保留既有檔案不覆蓋
+    size_t fetchAndSaveAll(const std::vector<FetchRequest>& requests);
+
+    // 切換為串流模式：回應內容邊下載邊交給 factory 建立的處理者，
+    // 原始 JSON 只在 options.archive 為 true 且處理成功時才於背景寫檔
+    void setResponseStream(ResponseStreamFactory factory);
+
+    // 設定進度回呼，於抓取迴圈的執行緒上呼叫
+    void setProgressCallback(ProgressCallback callback);
 
 private:
     std::string apiKey_; // API 金鑰
+    FetchOptions options_;
+    std::unique_ptr<CurlHandlePool> pool_; // 第一次抓取時建立
+    ResponseStreamFactory streamFactory_;  // 空值表示一般模式
+    ProgressCallback progress_;
 
     // 靜態回呼函式：供 libcurl 使用，將下載內容寫入字串
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output);
 
-    // 從 API 抓取單一股票代碼的 JSON 資料
-    std::string getStockData(const std::string& symbol);
+    // 組出單一請求的網址
+    std::string requestUrl(const FetchRequest& request) const;
+
+    // 原始 JSON 的存檔路徑
+    std::string jsonPath(const std::string& symbol) const;
 
     // 儲存 JSON 資料到本地檔案
-    void saveJson(const std::string& symbol, const std::string& jsonData);
+    bool saveJson(const std::string& symbol, const std::string& jsonData);
+
+    // 將 compact 回應與既有檔案合併為 merged；回傳 false 且 needFull 為 true 表示需改抓完整歷史
+    bool mergeWithCache(const std::string& symbol, const std::string& jsonData, std::string& merged, bool& needFull);
 };
@@ -0,0 +1,89 @@
+// SymbolUniverse.cpp
+#include "SymbolUniverse.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+    // 代碼會用於檔名與網址，只接受英數字、點與連字號
+    bool validSymbol(const std::string& symbol) {
+        return !symbol.empty() && std::all_of(symbol.begin(), symbol.end(), [](unsigned char c) {
+            return std::isalnum(c) || c == '.' || c == '-';
+        });
+    }
+}
+
+bool loadUniverse(const std::string& path, std::vector<UniverseEntry>& entries, std::string& error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        error = "無法開啟股票清單 " + path;
+        return false;
+    }
+    entries.clear();
+    std::unordered_set<std::string> seen;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        UniverseEntry entry;
+        if (!(fields >> entry.symbol)) {
+            continue;
+        }
+        std::string priority, extra;
+        if (fields >> priority) {
+            size_t used = 0;
+            try {
+                entry.priority = std::stoi(priority, &used);
+            } catch (const std::exception&) {
+                used = 0;
+            }
+            if (used != priority.size()) {
+                error = path + " 第 " + std::to_string(lineNumber) + " 行的優先度不是整數: " + priority;
+                return false;
+            }
+        }
+        if (fields >> extra || !validSymbol(entry.symbol)) {
+            error = path + " 第 " + std::to_string(lineNumber) + " 行格式錯誤: " + line;
+            return false;
+        }
+        if (!seen.insert(entry.symbol).second) {
+            std::cerr << "[LOG] " << path << " 第 " << lineNumber << " 行重複的代碼 " << entry.symbol << "，已略過" << std::endl;
+            continue;
+        }
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const UniverseEntry& a, const UniverseEntry& b) {
+        return a.priority > b.priority;
+    });
+    return true;
+}
+
+uint32_t shardOf(const std::string& symbol, uint32_t shardCount) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : symbol) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    // FNV-1a 的低位元只受各字元低位元影響，取餘數前先以 murmur3 的 fmix32 混合高位元
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return shardCount == 0 ? 0 : hash % shardCount;
+}
+
+std::vector<UniverseEntry> selectShard(const std::vector<UniverseEntry>& entries, uint32_t shardIndex, uint32_t shardCount) {
+    std::vector<UniverseEntry> shard;
+    for (const UniverseEntry& entry : entries) {
+        if (shardOf(entry.symbol, shardCount) == shardIndex) {
+            shard.push_back(entry);
+        }
+    }
+    return shard;
+}
@@ -0,0 +1,24 @@
+// SymbolUniverse.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 股票清單中的一個代碼；priority 越大越先抓取
+struct UniverseEntry {
+    std::string symbol;
+    int priority = 0;
+};
+
+// 讀取股票清單檔：每行一個代碼，可在代碼後以空白隔開加上整數優先度（預設 0），
+// # 之後為註解，空白行略過，重複的代碼只保留第一次出現者。
+// 回傳的清單依優先度由高到低排列，同優先度維持檔案中的順序；格式錯誤時回傳 false 並由 error 說明行號
+bool loadUniverse(const std::string& path, std::vector<UniverseEntry>& entries, std::string& error);
+
+// 代碼的分片編號：以 FNV-1a 雜湊取餘數，與平台、編譯器及行程無關，
+// 因此 N 個行程各自計算也會得到互不重疊且涵蓋全部代碼的分割
+uint32_t shardOf(const std::string& symbol, uint32_t shardCount);
+
+// 取出屬於第 shardIndex 片的代碼，維持原本的優先度順序
+std::vector<UniverseEntry> selectShard(const std::vector<UniverseEntry>& entries, uint32_t shardIndex, uint32_t shardCount);
@@ -1,36 +1,135 @@
 // main.cpp
 #include "StockDataFetcher.h"
+#include "FetchScheduler.h"
+#include "SymbolUniverse.h"
+#include "ShardStatus.h"
+#include <cstdio>
 #include <cstdlib>  // 為了使用 std::getenv
+#include <iostream>
+#include <string>
 
-int main() {
+// 用法：alphavantage [--base-url 網址] [--rpm 每分鐘請求數] [--burst 突發數] [--concurrency 同時連線數] [--out 資料夾] [--metrics 請求記錄檔]
+//                    [--today YYYY-MM-DD] [--compact-days 交易日數] [--force-full]
+//                    [--universe 股票清單=symbols.txt] [--shard 編號/總數] [--status 進度檔] [--show-status]
+// 預設依輸出資料夾中既有檔案的最後更新日排程：已是最新交易日的代碼略過，缺少少數交易日的只抓 compact 並合併，
+// 新代碼或缺口較大的抓完整歷史；--force-full 則不看快取，全部重新抓完整歷史。
+// 水平擴充時啟動 N 個行程，分別帶 --shard 0/N … --shard N-1/N 並指向同一個 --out 資料夾：
+// 每個行程依代碼雜湊只抓自己那一片，進度寫入共用的進度檔（預設為 --out 中的 fetch_status.txt），
+// 以 --show-status 可隨時彙總。限速各行程獨立計算，--rpm 應設為方案配額除以 N
+int main(int argc, char* argv[]) {
     // 從環境變數讀取 API 金鑰，若未設定則使用預設值
-    std::string apiKey = "QZDLARSUDF976X0R";
+    const char* envKey = std::getenv("ALPHAVANTAGE_API_KEY");
+    std::string apiKey = envKey ? envKey : "QZDLARSUDF976X0R";
 
-    // 建立 StockDataFetcher 物件
-    StockDataFetcher fetcher(apiKey);
+    FetchOptions options;
+    std::string today = FetchScheduler::latestTradingDay();
+    int compactDays = 90;
+    bool forceFull = false, showStatus = false;
+    std::string universePath = "symbols.txt", statusPath;
+    unsigned shardIndex = 0, shardCount = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--force-full" || flag == "--show-status") {
+            (flag == "--force-full" ? forceFull : showStatus) = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[ERROR] 參數缺少值: " << flag << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (flag == "--base-url") {
+            options.baseUrl = value;
+        } else if (flag == "--rpm") {
+            options.requestsPerMinute = std::atof(value.c_str());
+        } else if (flag == "--burst") {
+            options.burst = std::atof(value.c_str());
+        } else if (flag == "--concurrency") {
+            options.maxConcurrency = std::atoi(value.c_str());
+        } else if (flag == "--metrics") {
+            options.metricsFile = value;
+        } else if (flag == "--out") {
+            options.outputDir = value;
+        } else if (flag == "--today") {
+            today = value;
+        } else if (flag == "--compact-days") {
+            compactDays = std::atoi(value.c_str());
+        } else if (flag == "--universe") {
+            universePath = value;
+        } else if (flag == "--status") {
+            statusPath = value;
+        } else if (flag == "--shard") {
+            if (std::sscanf(value.c_str(), "%u/%u", &shardIndex, &shardCount) != 2 || shardCount == 0 || shardIndex >= shardCount) {
+                std::cerr << "[ERROR] --shard 格式應為 編號/總數，例如 0/4: " << value << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "[ERROR] 未知參數: " << flag << std::endl;
+            return 1;
+        }
+    }
 
-    // 設定要抓取的股票代碼
-    std::vector<std::string> symbols = {
-        "TSLA",   // Tesla
-        "AAPL",   // Apple
-        "MSFT",   // Microsoft
-        "GOOGL",  // Alphabet (Google)
-        "AMZN",   // Amazon
-        "NVDA",   // NVIDIA
-        "META",   // Meta (Facebook)
-        "INTC",   // Intel
-        "ORCL",   // Oracle
-        "IBM",    // IBM
-        "NFLX",   // Netflix
-        "AMD",    // AMD
-        "BABA",   // Alibaba
-        "JPM",    // JPMorgan Chase
-        "V",      // Visa
-        "UNH"     // UnitedHealth Group
-    };
+    if (statusPath.empty()) {
+        statusPath = options.outputDir + "/fetch_status.txt";
+    }
+    if (showStatus) {
+        if (!ShardStatus::summarize(statusPath, std::cout)) {
+            std::cerr << "[ERROR] 無法讀取進度檔 " << statusPath << std::endl;
+            return 1;
+        }
+        return 0;
+    }
 
-    // 執行抓取與儲存
-    fetcher.fetchAndSaveAll(symbols);
+    // 讀取股票清單並取出本行程負責的分片
+    std::vector<UniverseEntry> universe;
+    std::string error;
+    if (!loadUniverse(universePath, universe, error)) {
+        std::cerr << "[ERROR] " << error << std::endl;
+        return 1;
+    }
+    std::vector<std::string> symbols;
+    for (const UniverseEntry& entry : selectShard(universe, shardIndex, shardCount)) {
+        symbols.push_back(entry.symbol);
+    }
+    std::cout << "[LOG] 股票清單 " << universePath << " 共 " << universe.size() << " 個代碼，分片 " << shardIndex << "/" << shardCount
+              << " 負責 " << symbols.size() << " 個" << std::endl;
 
-    return 0;
+    // 依快取狀態決定每個代碼的抓取方式
+    std::vector<FetchRequest> requests;
+    if (forceFull) {
+        for (const std::string& symbol : symbols) {
+            requests.push_back({symbol, OutputSize::Full, false});
+        }
+    } else {
+        FetchScheduler scheduler(options.outputDir, compactDays);
+        size_t skipped = 0, compact = 0, full = 0;
+        for (const FetchPlan& plan : scheduler.planAll(symbols, today)) {
+            std::cout << "[LOG] 排程 " << plan.symbol << ": " << fetchModeName(plan.mode)
+                      << (plan.lastRefreshed.empty() ? "（無快取）" : "（最後更新 " + plan.lastRefreshed + "，缺 " + std::to_string(plan.missingDays) + " 個交易日）")
+                      << std::endl;
+            if (plan.mode == FetchMode::Skip) {
+                skipped++;
+            } else if (plan.mode == FetchMode::Compact) {
+                compact++;
+                requests.push_back({plan.symbol, OutputSize::Compact, true});
+            } else {
+                full++;
+                requests.push_back({plan.symbol, OutputSize::Full, false});
+            }
+        }
+        std::cout << "[LOG] 最新交易日 " << today << "：略過 " << skipped << "，compact " << compact << "，full " << full << std::endl;
+    }
+
+    // 執行抓取與儲存，每個代碼完成時更新共用進度檔中本分片的那一行
+    ShardStatus status(statusPath, shardIndex, shardCount);
+    if (!status.valid()) {
+        std::cerr << "[ERROR] 無法寫入進度檔 " << statusPath << std::endl;
+    }
+    status.start(requests.size(), symbols.size() - requests.size());
+    StockDataFetcher fetcher(apiKey, options);
+    fetcher.setProgressCallback([&status](const std::string& symbol, bool ok) { status.update(symbol, ok); });
+    size_t saved = requests.empty() ? 0 : fetcher.fetchAndSaveAll(requests);
+    status.finish();
+
+    return saved == requests.size() ? 0 : 1;
 }